@@ -0,0 +1,30 @@
+-- TÖVE Demo: checks Graphics:optimize on hidden paths.
+-- (C) 2018 Bernhard Liebl, MIT license.
+
+local tove = require "tove"
+
+-- an opaque path with visibility="hidden" must neither occlude the
+-- visible path below it nor get merged into a visible neighbour.
+
+local svg = [[
+<svg xmlns="http://www.w3.org/2000/svg" width="200" height="200">
+	<rect x="20" y="20" width="100" height="100" fill="#ff0000"/>
+	<rect x="0" y="0" width="200" height="200" fill="#0000ff"
+		visibility="hidden"/>
+	<rect x="120" y="20" width="60" height="100" fill="#0000ff"/>
+</svg>
+]]
+
+local graphics = tove.newGraphics(svg)
+local stats = graphics:optimize()
+
+assert(stats.occluded == 0, "hidden path occluded a visible one")
+assert(stats.merged == 0, "hidden path got merged")
+assert(stats.paths.after == 3)
+
+graphics:setDisplay("mesh")
+
+function love.draw()
+	love.graphics.print("optimize with hidden paths: ok", 10, 10)
+	graphics:draw(love.graphics.getWidth() / 2, love.graphics.getHeight() / 2)
+end
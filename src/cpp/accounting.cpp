@@ -0,0 +1,49 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#include "accounting.h"
+#include "mesh/triangles.h"
+#include <algorithm>
+
+BEGIN_TOVE_NAMESPACE
+
+namespace memory {
+
+// zero initialized, as static storage.
+std::atomic<int64_t> bytes[MEMORY_NUM_CATEGORIES];
+std::atomic<uint64_t> budget(0);
+
+static inline uint64_t get(Category category) {
+	return uint64_t(std::max(int64_t(0), bytes[category].load()));
+}
+
+ToveMemoryStats getStats() {
+	ToveMemoryStats stats;
+	stats.meshes = get(MEMORY_MESHES);
+	stats.triangles = TriangleCache::getGlobalBudget().stats.bytes;
+	stats.cleaners = get(MEMORY_CLEANERS);
+	stats.geometry = get(MEMORY_GEOMETRY);
+	stats.gradients = get(MEMORY_GRADIENTS);
+	stats.parser = get(MEMORY_PARSER);
+	stats.total = stats.meshes + stats.triangles + stats.cleaners +
+		stats.geometry + stats.gradients + stats.parser;
+	stats.budget = budget;
+	return stats;
+}
+
+bool exceeded() {
+	const uint64_t limit = budget;
+	return limit > 0 && getStats().total > limit;
+}
+
+} // namespace memory
+
+END_TOVE_NAMESPACE
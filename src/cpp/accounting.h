@@ -0,0 +1,59 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_ACCOUNTING
+#define __TOVE_ACCOUNTING 1
+
+#include "common.h"
+#include <atomic>
+
+BEGIN_TOVE_NAMESPACE
+
+// global accounting of the memory tove allocates on its own. buffers
+// that live in LÖVE (e.g. ByteData, Meshes) are not counted. triangle
+// caches keep their own accounting (see TriangleBudget).
+
+namespace memory {
+	enum Category {
+		MEMORY_MESHES,
+		MEMORY_CLEANERS,
+		MEMORY_GEOMETRY,
+		MEMORY_GRADIENTS,
+		MEMORY_PARSER,
+		MEMORY_NUM_CATEGORIES
+	};
+
+	// updated from worker threads as well.
+	extern std::atomic<int64_t> bytes[MEMORY_NUM_CATEGORIES];
+	extern std::atomic<uint64_t> budget;
+
+	inline void account(Category category, int64_t delta) {
+		bytes[category] += delta;
+	}
+
+	// sets accounted to size and accounts for the difference.
+	inline void update(Category category, size_t &accounted, size_t size) {
+		if (size != accounted) {
+			account(category, int64_t(size) - int64_t(accounted));
+			accounted = size;
+		}
+	}
+
+	ToveMemoryStats getStats();
+
+	// true if the total exceeds the global budget.
+	bool exceeded();
+
+} // namespace memory
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_ACCOUNTING
@@ -0,0 +1,245 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#include "batch.h"
+#include "mesh/mesh.h"
+#include <cstring>
+
+BEGIN_TOVE_NAMESPACE
+
+MeshBatch::MeshBatch() :
+	stride(0),
+	layoutChanged(true),
+	indicesChanged(true),
+	dirtyBegin(std::numeric_limits<int32_t>::max()),
+	dirtyEnd(0),
+	vertexCount(0),
+	indexCount(0) {
+}
+
+// batches only draw the finest level of detail, which comes first.
+static ToveIndexRange getBatchedIndexRange(const AbstractMesh *mesh) {
+	if (mesh->getNumLODs() > 1) {
+		return mesh->getLODIndexRange(0);
+	}
+	return ToveIndexRange{0, mesh->getIndexCount()};
+}
+
+int32_t MeshBatch::countIndices(const MeshRef &mesh) {
+	const int32_t n = getBatchedIndexRange(mesh.get()).count;
+	if (mesh->getIndexMode() == TRIANGLES_STRIP) {
+		return n >= 3 ? 3 * (n - 2) : 0;
+	}
+	return n;
+}
+
+void MeshBatch::layout() {
+	int32_t vertex = 0;
+	int32_t index = 0;
+
+	for (Member &member : members) {
+		const int32_t n = member.mesh->getVertexCount();
+		member.vertices = ToveVertexRange{vertex, n};
+		vertex += n;
+
+		const int32_t m = countIndices(member.mesh);
+		member.indices = ToveIndexRange{index, m};
+		index += m;
+	}
+
+	vertexCount = vertex;
+	indexCount = index;
+
+	layoutChanged = true;
+	indicesChanged = true;
+	dirtyBegin = 0;
+	dirtyEnd = members.size();
+}
+
+int MeshBatch::add(const MeshRef &mesh) {
+	const int s = mesh->getVertexByteSize(TOVE_VERTEX_FLOAT32);
+	if (stride != 0 && s != stride) {
+		tove::report::warn("cannot batch meshes with different vertex layouts.");
+		return -1;
+	}
+	stride = s;
+
+	Member member;
+	member.mesh = mesh;
+	member.matrix[0] = 1;
+	member.matrix[1] = 0;
+	member.matrix[2] = 0;
+	member.matrix[3] = 1;
+	member.matrix[4] = 0;
+	member.matrix[5] = 0;
+	members.push_back(member);
+
+	layout();
+	return members.size() - 1;
+}
+
+bool MeshBatch::remove(int i) {
+	if (i < 0 || i >= size()) {
+		return false;
+	}
+	members.erase(members.begin() + i);
+	layout();
+	return true;
+}
+
+bool MeshBatch::setTransform(int i,
+	float a, float b, float c, float d, float e, float f) {
+
+	if (i < 0 || i >= size()) {
+		return false;
+	}
+	float *m = members[i].matrix;
+	m[0] = a;
+	m[1] = b;
+	m[2] = c;
+	m[3] = d;
+	m[4] = e;
+	m[5] = f;
+	markDirty(i);
+	return true;
+}
+
+void MeshBatch::changed(int i, ToveMeshUpdateFlags flags) {
+	if (i < 0 || i >= size() || flags == 0) {
+		return;
+	}
+
+	const Member &member = members[i];
+	if (member.mesh->getVertexCount() != member.vertices.count ||
+		countIndices(member.mesh) != member.indices.count) {
+		layout();
+		return;
+	}
+
+	if (flags & (UPDATE_MESH_TRIANGLES | UPDATE_MESH_GEOMETRY)) {
+		indicesChanged = true;
+	}
+	markDirty(i);
+}
+
+ToveMeshUpdateFlags MeshBatch::fetchUpdates() {
+	ToveMeshUpdateFlags flags = 0;
+	if (layoutChanged) {
+		flags |= UPDATE_MESH_GEOMETRY;
+	}
+	if (indicesChanged) {
+		flags |= UPDATE_MESH_TRIANGLES;
+	}
+	if (dirtyBegin < dirtyEnd) {
+		flags |= UPDATE_MESH_VERTICES;
+	}
+	layoutChanged = false;
+	indicesChanged = false;
+	return flags;
+}
+
+ToveIndexRange MeshBatch::getMemberIndexRange(int i) const {
+	if (i < 0 || i >= size()) {
+		return ToveIndexRange{0, 0};
+	}
+	return members[i].indices;
+}
+
+ToveVertexRange MeshBatch::copyVertexData(void *buffer, int32_t size) {
+	const int32_t end = std::min(dirtyEnd, int32_t(members.size()));
+	if (dirtyBegin >= end || stride == 0) {
+		return ToveVertexRange{0, 0};
+	}
+
+	const int32_t capacity = size / stride;
+	int32_t first = std::numeric_limits<int32_t>::max();
+	int32_t last = 0;
+
+	int32_t i = dirtyBegin;
+	for (; i < end; i++) {
+		const Member &member = members[i];
+		const ToveVertexRange &range = member.vertices;
+		if (range.first + range.count > capacity) {
+			break;
+		}
+
+		const Vertices vertices = member.mesh->peekVertices(0);
+		const float *m = member.matrix;
+		uint8_t *p = static_cast<uint8_t*>(buffer) + range.first * stride;
+
+		for (int32_t j = 0; j < range.count; j++) {
+			const vec2 &v = vertices[j];
+			// position first, then the baked color (see ColorMesh).
+			std::memcpy(p, &v, stride);
+			float *q = reinterpret_cast<float*>(p);
+			q[0] = m[0] * v.x + m[2] * v.y + m[4];
+			q[1] = m[1] * v.x + m[3] * v.y + m[5];
+			p += stride;
+		}
+
+		first = std::min(first, range.first);
+		last = std::max(last, range.first + range.count);
+	}
+
+	// members that did not fit stay dirty.
+	if (i < end) {
+		dirtyBegin = i;
+		dirtyEnd = end;
+	} else {
+		dirtyBegin = std::numeric_limits<int32_t>::max();
+		dirtyEnd = 0;
+	}
+
+	if (first >= last) {
+		return ToveVertexRange{0, 0};
+	}
+	return ToveVertexRange{first, last - first};
+}
+
+void MeshBatch::copyIndexData(uint32_t *indices, int32_t count) const {
+	std::vector<ToveVertexIndex> source;
+
+	for (const Member &member : members) {
+		const ToveIndexRange &range = member.indices;
+		if (range.first + range.count > count) {
+			break;
+		}
+
+		const AbstractMesh *mesh = member.mesh.get();
+		const int32_t total = mesh->getIndexCount();
+		source.resize(total);
+		mesh->copyIndexData(source.data(), total);
+
+		const ToveIndexRange lod = getBatchedIndexRange(mesh);
+		const ToveVertexIndex *in = source.data() + lod.first;
+		const int32_t n = lod.count;
+
+		const uint32_t offset = member.vertices.first;
+		uint32_t *out = indices + range.first;
+
+		if (mesh->getIndexMode() == TRIANGLES_STRIP) {
+			// batches are drawn as triangle lists. flip every other
+			// triangle to keep the strip's winding.
+			for (int32_t i = 0; i + 2 < n; i++) {
+				const int k = i & 1;
+				*out++ = offset + in[i + k];
+				*out++ = offset + in[i + 1 - k];
+				*out++ = offset + in[i + 2];
+			}
+		} else {
+			for (int32_t i = 0; i < n; i++) {
+				*out++ = offset + in[i];
+			}
+		}
+	}
+}
+
+END_TOVE_NAMESPACE
@@ -0,0 +1,101 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_BATCH
+#define __TOVE_BATCH 1
+
+#include "common.h"
+#include <vector>
+
+BEGIN_TOVE_NAMESPACE
+
+// merges the meshes of many Graphics, each with its own transform, into
+// one vertex and index buffer, so that they draw in one call. members
+// must have colors baked into their vertices (i.e. be color meshes), so
+// there is no paint table to merge. each member keeps its range in the
+// merged buffers, so that changes only copy the members that changed.
+
+class MeshBatch {
+	struct Member {
+		MeshRef mesh;
+		float matrix[6]; // a, b, c, d, e, f
+		ToveVertexRange vertices;
+		ToveIndexRange indices;
+	};
+
+	std::vector<Member> members;
+
+	// vertex stride shared by all members.
+	int stride;
+
+	// new buffers are needed, as member vertex or index counts changed.
+	bool layoutChanged;
+	bool indicesChanged;
+
+	// range of members whose vertices need to be copied again.
+	int32_t dirtyBegin;
+	int32_t dirtyEnd;
+
+	int32_t vertexCount;
+	int32_t indexCount;
+
+	inline void markDirty(int i) {
+		dirtyBegin = std::min(dirtyBegin, int32_t(i));
+		dirtyEnd = std::max(dirtyEnd, int32_t(i + 1));
+	}
+
+	static int32_t countIndices(const MeshRef &mesh);
+	void layout();
+
+public:
+	MeshBatch();
+
+	inline int size() const {
+		return members.size();
+	}
+
+	// adds a member and returns its index.
+	int add(const MeshRef &mesh);
+	bool remove(int i);
+
+	bool setTransform(int i,
+		float a, float b, float c, float d, float e, float f);
+
+	// tells the batch that a member's mesh got updated with the given
+	// flags (as returned from tesselating).
+	void changed(int i, ToveMeshUpdateFlags flags);
+
+	// returns UPDATE_MESH_GEOMETRY if the merged buffers need to be
+	// recreated, UPDATE_MESH_TRIANGLES if indices need to be copied
+	// again and UPDATE_MESH_VERTICES if vertices need to be copied.
+	ToveMeshUpdateFlags fetchUpdates();
+
+	inline int32_t getVertexCount() const {
+		return vertexCount;
+	}
+
+	inline int32_t getIndexCount() const {
+		return indexCount;
+	}
+
+	ToveIndexRange getMemberIndexRange(int i) const;
+
+	// copies the vertices of all members changed since the last call
+	// into buffer (at their natural offsets) and returns the range copied.
+	ToveVertexRange copyVertexData(void *buffer, int32_t size);
+
+	// copies all indices as 32 bit triangle list.
+	void copyIndexData(uint32_t *indices, int32_t count) const;
+};
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_BATCH
@@ -107,6 +107,18 @@ typedef SharedPtr<AbstractFeed> FeedRef;
 class Palette;
 typedef SharedPtr<Palette> PaletteRef;
 
+class Timeline;
+typedef SharedPtr<Timeline> TimelineRef;
+
+class MorphPlan;
+typedef SharedPtr<MorphPlan> MorphPlanRef;
+
+class InstanceSet;
+typedef SharedPtr<InstanceSet> InstanceSetRef;
+
+class MeshBatch;
+typedef SharedPtr<MeshBatch> MeshBatchRef;
+
 typedef SharedPtr<std::string> NameRef;
 
 inline int nextpow2(uint32_t v) {
@@ -12,6 +12,7 @@
 #include "geometry_data.h"
 #include "../common.h"
 #include "../utils.h"
+#include "../accounting.h"
 #include <memory.h>
 #include <iostream>
 
@@ -21,7 +22,7 @@ GeometryData::GeometryData(
 	int maxCurves,
 	int maxSubPaths,
 	bool fragmentShaderStrokes,
-	ToveShaderGeometryData &data) : data(data) {
+	ToveShaderGeometryData &data) : data(data), byteSize(0) {
 
 	std::memset(&data, 0, sizeof(ToveShaderGeometryData));
 
@@ -92,6 +93,8 @@ GeometryData::GeometryData(
 		data.lineRuns = nullptr;
 	} else {
 		data.lineRuns = new ToveLineRun[maxSubPaths];
+		memory::update(memory::MEMORY_GEOMETRY, byteSize,
+			maxSubPaths * sizeof(ToveLineRun));
 	}
 
 	// except for AllocateGeometryNoLinkData, the following fields will
@@ -106,6 +109,7 @@ GeometryData::GeometryData(
 
 GeometryData::~GeometryData() {
 	delete[] data.lineRuns;
+	memory::update(memory::MEMORY_GEOMETRY, byteSize, 0);
 }
 
 GeometryNoLinkData::GeometryNoLinkData(
@@ -128,6 +132,13 @@ GeometryNoLinkData::GeometryNoLinkData(
 	data.lookupTable[0] = new float[data.lookupTableSize];
 	data.lookupTable[1] = new float[data.lookupTableSize];
 	data.lookupTableMeta = new ToveLookupTableMeta;
+
+	memory::update(memory::MEMORY_GEOMETRY, byteSize, byteSize +
+		sizeof(ToveBounds) +
+		data.listsTextureRowBytes * data.listsTextureSize[1] +
+		data.curvesTextureRowBytes * data.curvesTextureSize[1] +
+		2 * data.lookupTableSize * sizeof(float) +
+		sizeof(ToveLookupTableMeta));
 }
 
 GeometryNoLinkData::~GeometryNoLinkData() {
@@ -21,6 +21,9 @@ class GeometryData {
 protected:
 	ToveShaderGeometryData &data;
 
+	// bytes of the buffers we allocated (see accounting.h).
+	size_t byteSize;
+
 public:
 	GeometryData(
 		int maxCurves,
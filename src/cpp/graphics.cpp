@@ -22,12 +22,16 @@
 
 #include "graphics.h"
 #include "mesh/meshifier.h"
+#include "morph.h"
 #include "nsvg.h"
 #include <sstream>
 #include <algorithm>
+#include <cstring>
 
 BEGIN_TOVE_NAMESPACE
 
+uint32_t Graphics::nextRigidEpoch = 0;
+
 PaintIndices::PaintIndices(Graphics *graphics) {
 	const int n = graphics->getNumPaths();
 	paints.reserve(n);
@@ -108,14 +112,62 @@ static void copyPaths(
 	}
 }
 
+static ClipperLib::IntRect computeBounds(const ClipperLib::Paths &paths) {
+	ClipperLib::IntRect r;
+	r.left = r.top = std::numeric_limits<ClipperLib::cInt>::max();
+	r.right = r.bottom = std::numeric_limits<ClipperLib::cInt>::min();
+	for (const auto &path : paths) {
+		for (const auto &p : path) {
+			r.left = std::min(r.left, p.X);
+			r.top = std::min(r.top, p.Y);
+			r.right = std::max(r.right, p.X);
+			r.bottom = std::max(r.bottom, p.Y);
+		}
+	}
+	return r;
+}
+
 #ifdef NSVG_CLIP_PATHS
-Clip::Clip(TOVEclipPath *clipPath) {
+static bool isConvex(const ClipperLib::Paths &paths) {
+	if (paths.size() != 1 || paths[0].size() < 3) {
+		return false;
+	}
+	const ClipperLib::Path &path = paths[0];
+	const int n = path.size();
+	int sign = 0;
+	for (int i = 0; i < n; i++) {
+		const auto &a = path[i];
+		const auto &b = path[(i + 1) % n];
+		const auto &c = path[(i + 2) % n];
+		const double cross =
+			double(b.X - a.X) * double(c.Y - b.Y) -
+			double(b.Y - a.Y) * double(c.X - b.X);
+		const int s = cross > 0.0 ? 1 : (cross < 0.0 ? -1 : 0);
+		if (s != 0) {
+			if (sign != 0 && s != sign) {
+				return false;
+			}
+			sign = s;
+		}
+	}
+	return true;
+}
+
+Clip::Clip(TOVEclipPath *clipPath) :
+	computedTesselator(0),
+	computedKey(0),
+	convex(false) {
+
     std::memset(&nsvg, 0, sizeof(nsvg));
     copyFromNSVG(nullptr, &nsvg.shapes, paths, clipPath->shapes);
     nsvg.index = clipPath->index;
 }
 
-Clip::Clip(const ClipRef &source, const nsvg::Transform &transform) {
+Clip::Clip(const ClipRef &source, const nsvg::Transform &transform) :
+	computedTesselator(0),
+	computedKey(0),
+	convex(false) {
+
 	std::memset(&nsvg, 0, sizeof(nsvg));
 	copyPaths(nullptr, &nsvg.shapes, paths, source->paths);
 	nsvg.index = source->nsvg.index;
@@ -125,7 +177,44 @@ Clip::Clip(const ClipRef &source, const nsvg::Transform &transform) {
 }
 
 void Clip::compute(const AbstractTesselator &tess) {
-    computed = tess.toClipPath(paths);
+	const uint64_t key = tess.getClipPathKey();
+	if (computedTesselator == tess.getId() && computedKey == key) {
+		return;
+	}
+
+	computed = tess.toClipPath(paths);
+	bounds = computeBounds(computed);
+	convex = isConvex(computed);
+
+	computedTesselator = tess.getId();
+	computedKey = key;
+}
+
+Clip::Coverage Clip::classify(const ClipperLib::Paths &subject) const {
+	const ClipperLib::IntRect r = computeBounds(subject);
+
+	if (r.left > bounds.right || r.right < bounds.left ||
+		r.top > bounds.bottom || r.bottom < bounds.top) {
+		return OUTSIDE;
+	}
+
+	// a convex clip contains the subject if it contains its bounds.
+	if (convex) {
+		const ClipperLib::IntPoint corners[4] = {
+			ClipperLib::IntPoint(r.left, r.top),
+			ClipperLib::IntPoint(r.right, r.top),
+			ClipperLib::IntPoint(r.right, r.bottom),
+			ClipperLib::IntPoint(r.left, r.bottom)
+		};
+		for (const auto &p : corners) {
+			if (ClipperLib::PointInPolygon(p, computed[0]) == 0) {
+				return PARTIAL;
+			}
+		}
+		return INSIDE;
+	}
+
+	return PARTIAL;
 }
 
 
@@ -245,6 +334,10 @@ void Graphics::initialize(float width, float height) {
 	}
 
     changes |= CHANGED_BOUNDS | CHANGED_EXACT_BOUNDS | CHANGED_PAINT_INDICES;
+
+	packPoints = false;
+
+	newRigidEpoch();
 }
 
 Graphics::Graphics() : changes(CHANGED_BOUNDS | CHANGED_EXACT_BOUNDS) {
@@ -309,6 +402,7 @@ void Graphics::clear() {
 			p->removeObserver(this);
 		}
 		paths.clear();
+		packed.reset();
 		nsvg.shapes = nullptr;
 		changed(CHANGED_GEOMETRY);
 	}
@@ -469,11 +563,207 @@ const float *Graphics::getExactBounds() {
 }
 
 void Graphics::clean(float eps) {
+	ObserverBatch batch;
 	for (const auto &p : paths) {
 		p->clean(eps);
 	}
 }
 
+// nanosvg keeps shapes with visibility="hidden", they just lack the flag.
+static bool isVisible(const PathRef &path) {
+	return (path->getNSVG()->flags & NSVG_FLAGS_VISIBLE) != 0;
+}
+
+static bool hasOpaqueSolidFill(const PathRef &path) {
+	if (!isVisible(path) || !path->hasFill() || path->getOpacity() < 1.0f) {
+		return false;
+	}
+#ifdef NSVG_CLIP_PATHS
+	if (!path->getClipIndices().empty()) {
+		return false;
+	}
+#endif
+	const PaintRef &paint = path->getFillColor();
+	return paint && paint->getType() == PAINT_SOLID && paint->isOpaque();
+}
+
+static bool haveSameFill(const PathRef &a, const PathRef &b) {
+	ToveRGBA ca, cb;
+	a->getFillColor()->getRGBA(ca, 1.0f);
+	b->getFillColor()->getRGBA(cb, 1.0f);
+	return ca.r == cb.r && ca.g == cb.g && ca.b == cb.b && ca.a == cb.a;
+}
+
+static int countVertices(const ClipperLib::Paths &paths) {
+	int n = 0;
+	for (const auto &path : paths) {
+		n += path.size();
+	}
+	return n;
+}
+
+static bool touches(
+	const ClipperLib::IntRect &a, const ClipperLib::IntRect &b) {
+
+	return a.left <= b.right && b.left <= a.right &&
+		a.top <= b.bottom && b.top <= a.bottom;
+}
+
+static void setPolygons(
+	const PathRef &path, const ClipperLib::Paths &polygons, float scale) {
+
+	path->closeSubpath();
+	path->removeSubpaths();
+	for (const auto &polygon : polygons) {
+		if (polygon.size() < 3) {
+			continue;
+		}
+		const SubpathRef subpath = path->beginSubpath();
+		subpath->moveTo(polygon[0].X / scale, polygon[0].Y / scale);
+		for (size_t i = 1; i < polygon.size(); i++) {
+			subpath->lineTo(polygon[i].X / scale, polygon[i].Y / scale);
+		}
+		path->closeSubpath(true);
+	}
+	// simplified polygons don't overlap and holes have the opposite
+	// orientation, so both fill rules give the same result here. note
+	// that setFillRule() maps to nsvg's rules swapped (i.e. this ends
+	// up as NSVG_FILLRULE_EVENODD), which is fine for that reason.
+	path->setFillRule(TOVE_FILLRULE_NON_ZERO);
+}
+
+ToveOptimizeStats Graphics::optimize(AbstractTesselator &tess) {
+	ToveOptimizeStats stats;
+	std::memset(&stats, 0, sizeof(stats));
+
+	const int n = paths.size();
+	stats.numPathsBefore = n;
+	if (n < 1) {
+		return stats;
+	}
+
+	const float *bounds = getBounds();
+	const float extent = std::max(
+		bounds[2] - bounds[0], bounds[3] - bounds[1]);
+	tess.beginTesselate(this, 1.0f / extent);
+	const float scale = tess.getClipPathScale();
+
+	std::vector<ClipperLib::Paths> fills(n);
+	for (int i = 0; i < n; i++) {
+		if (paths[i]->hasFill()) {
+			fills[i] = tess.toClipPath({paths[i]});
+			stats.numVerticesBefore += countVertices(fills[i]);
+		}
+	}
+
+	tess.endTesselate();
+
+	// going from top to bottom, remove paths whose fill is covered by
+	// the opaque fills above them. paths with lines are kept, as lines
+	// reach beyond the fill.
+	std::vector<bool> keep(n, true);
+	ClipperLib::Paths covered;
+	for (int i = n - 1; i >= 0; i--) {
+		const PathRef &path = paths[i];
+		if (!isVisible(path)) {
+			// neither occludes nor gets occluded.
+			continue;
+		} else if (!path->hasFill() || path->hasStroke() || covered.empty()) {
+			// nothing to test.
+		} else {
+			ClipperLib::Clipper c;
+			c.AddPaths(fills[i], ClipperLib::ptSubject, true);
+			c.AddPaths(covered, ClipperLib::ptClip, true);
+			ClipperLib::Paths visible;
+			c.Execute(ClipperLib::ctDifference, visible,
+				ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+			if (visible.empty()) {
+				keep[i] = false;
+				stats.numOccluded++;
+				continue;
+			}
+		}
+
+		if (hasOpaqueSolidFill(path)) {
+			ClipperLib::Clipper c;
+			c.AddPaths(covered, ClipperLib::ptSubject, true);
+			c.AddPaths(fills[i], ClipperLib::ptClip, true);
+			c.Execute(ClipperLib::ctUnion, covered,
+				ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		}
+	}
+
+	// merge runs of touching paths with the same opaque solid fill and
+	// no line. paths in between got removed, so they are not in the way.
+	std::vector<PathRef> optimized;
+	optimized.reserve(n);
+	ObserverBatch batch;
+
+	int i = 0;
+	while (i < n) {
+		if (!keep[i]) {
+			i++;
+			continue;
+		}
+
+		const PathRef &path = paths[i];
+		ClipperLib::Paths merged = fills[i];
+		int numMerged = 0;
+		int j = i + 1;
+
+		if (hasOpaqueSolidFill(path) && !path->hasStroke()) {
+			ClipperLib::IntRect r = computeBounds(merged);
+			for (; j < n; j++) {
+				if (!keep[j]) {
+					continue;
+				}
+				const PathRef &next = paths[j];
+				if (!hasOpaqueSolidFill(next) || next->hasStroke() ||
+					!haveSameFill(path, next)) {
+					break;
+				}
+				const ClipperLib::IntRect s = computeBounds(fills[j]);
+				if (!touches(r, s)) {
+					break;
+				}
+				r.left = std::min(r.left, s.left);
+				r.top = std::min(r.top, s.top);
+				r.right = std::max(r.right, s.right);
+				r.bottom = std::max(r.bottom, s.bottom);
+				merged.insert(merged.end(), fills[j].begin(), fills[j].end());
+				keep[j] = false;
+				numMerged++;
+			}
+		}
+
+		// note that j may have skipped removed paths without merging.
+		if (numMerged > 0) {
+			ClipperLib::SimplifyPolygons(merged, ClipperLib::pftNonZero);
+			setPolygons(path, merged, scale);
+		}
+
+		stats.numMerged += numMerged;
+		stats.numVerticesAfter += countVertices(merged);
+		optimized.push_back(path);
+		i = j;
+	}
+
+	if (int(optimized.size()) < n) {
+		for (const PathRef &path : paths) {
+			path->removeObserver(this);
+		}
+		paths.clear();
+		nsvg.shapes = nullptr;
+		for (const PathRef &path : optimized) {
+			_appendPath(path);
+		}
+		packed.reset();
+	}
+
+	stats.numPathsAfter = paths.size();
+	return stats;
+}
+
 PathRef Graphics::hit(float x, float y) const {
     for (const auto &p : paths) {
 		if (p->isInside(x, y)) {
@@ -484,16 +774,46 @@ PathRef Graphics::hit(float x, float y) const {
 }
 
 void Graphics::setOrientation(ToveOrientation orientation) {
+	ObserverBatch batch;
 	for (int i = 0; i < paths.size(); i++) {
 		paths[i]->setOrientation(orientation);
 	}
 }
 
+bool Graphics::isRigid(const nsvg::Transform &transform) const {
+	if (!transform.isSimilarity()) {
+		return false;
+	}
+	if (transform.wantsScaleLineWidth() ||
+		std::abs(transform.getScale() - 1.0f) < 1e-4f) {
+		return true;
+	}
+	// line widths stay as they are, so strokes won't scale along.
+	for (const auto &path : paths) {
+		if (path->hasStroke()) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void Graphics::set(const GraphicsRef &source, const nsvg::Transform &transform) {
 	const int numPaths = source->paths.size();
 	setNumPaths(numPaths);
-	for (int i = 0; i < numPaths; i++) {
-		paths[i]->set(source->paths[i], transform);
+
+	// transforming ourselves rigidly keeps the topology of tesselations.
+	// the rigid flag stays with the changes until they get dispatched,
+	// i.e. also if an outer batch is still open.
+	const bool rigid = source.get() == this && isRigid(transform);
+	{
+		ObserverBatch batch;
+		ObserverBatch::RigidScope scope(rigid);
+		for (int i = 0; i < numPaths; i++) {
+			paths[i]->set(source->paths[i], transform);
+		}
+	}
+	if (rigid) {
+		rigidTransform.multiply(transform);
 	}
 
 #ifdef NSVG_CLIP_PATHS
@@ -514,29 +834,8 @@ ToveChangeFlags Graphics::fetchChanges(ToveChangeFlags flags) {
 }
 
 bool Graphics::morphify(const std::vector<GraphicsRef> &graphics) {
-	if (graphics.size() < 2) {
-		return false;
-	}
-
-	const int n = graphics[0]->getNumPaths();
-	for (int i = 0; i < graphics.size(); i++) {
-		if (graphics[i]->getNumPaths() != n) {
-			return false;
-		}
-	}
-
-	std::vector<PathRef> paths;
-	paths.reserve(graphics.size());
-
-	for (int j = 0; j < n; j++) {
-		paths.clear();
-		for (int i = 0; i < graphics.size(); i++) {
-			paths.push_back(graphics[i]->getPath(j));
-		}
-		Path::morphify(paths);
-	}
-
-	return true;	
+	MorphPlan plan;
+	return plan.analyze(graphics) && plan.apply(graphics);
 }
 
 void Graphics::rotate(ToveElementType what, int k) {
@@ -556,7 +855,45 @@ void Graphics::rotate(ToveElementType what, int k) {
 	}
 }
 
+void Graphics::ensurePacked() {
+	if (!packed || !packed->isValid(paths)) {
+		packed.reset(new PackedPoints(paths));
+	}
+}
+
+bool Graphics::animatePacked(const GraphicsRef &a, const GraphicsRef &b, float t) {
+	// only we get packed, a and b might be shared keyframes.
+	if (!packed || !packed->isValid(paths) ||
+		!packed->hasLayoutOf(a->paths) ||
+		!packed->hasLayoutOf(b->paths)) {
+		return false;
+	}
+
+	packed->animate(a->paths, b->paths, t);
+
+	ObserverBatch batch;
+	const int n = paths.size();
+	for (int i = 0; i < n; i++) {
+		paths[i]->animatePacked(a->paths[i], b->paths[i], t, i);
+	}
+	return true;
+}
+
+void Graphics::setPackedPoints(bool enabled) {
+	packPoints = enabled;
+	if (enabled) {
+		ensurePacked();
+	} else if (packed) {
+		packed->unpack();
+		packed.reset();
+	}
+}
+
 void Graphics::animate(const GraphicsRef &a, const GraphicsRef &b, float t) {
+	if (packPoints && animatePacked(a, b, t)) {
+		return;
+	}
+
 	const int n = a->paths.size();
 	if (n != b->paths.size()) {
 		if (tove::report::warnings()) {
@@ -574,8 +911,16 @@ void Graphics::animate(const GraphicsRef &a, const GraphicsRef &b, float t) {
 			addPath(tove_make_shared<Path>());
 		}
 	}
-	for (int i = 0; i < n; i++) {
-		paths[i]->animate(a->paths[i], b->paths[i], t, i);
+	{
+		ObserverBatch batch;
+		for (int i = 0; i < n; i++) {
+			paths[i]->animate(a->paths[i], b->paths[i], t, i);
+		}
+	}
+
+	if (packPoints) {
+		// layout changed (e.g. after a morphify), pack for next time.
+		ensurePacked();
 	}
 }
 
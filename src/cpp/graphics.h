@@ -13,6 +13,7 @@
 #define __TOVE_GRAPHICS 1
 
 #include "path.h"
+#include "packed.h"
 
 BEGIN_TOVE_NAMESPACE
 
@@ -23,7 +24,22 @@ class Clip;
 typedef SharedPtr<Clip> ClipRef;
 
 class Clip : public Referencable {
+private:
+	// clips never change after construction, so computed stays valid
+	// as long as the tesselator's clip path key does not change.
+	uint64_t computedTesselator;
+	uint64_t computedKey;
+
+	ClipperLib::IntRect bounds;
+	bool convex;
+
 public:
+	enum Coverage {
+		OUTSIDE,
+		INSIDE,
+		PARTIAL
+	};
+
 	Clip(TOVEclipPath *path);
 	Clip(const ClipRef &source, const nsvg::Transform &transform);
 
@@ -33,6 +49,9 @@ public:
 
 	void compute(const AbstractTesselator &tess);
 
+	// classifies subject polygons by their bounding box.
+	Coverage classify(const ClipperLib::Paths &subject) const;
+
 	TOVEclipPath nsvg;
 	std::vector<PathRef> paths;
 	ClipperLib::Paths computed;
@@ -111,6 +130,30 @@ private:
 	ToveChangeFlags changes;
 	PaintIndicesRef paintIndices;
 
+	bool packPoints;
+	std::unique_ptr<PackedPoints> packed;
+
+	// point changes done through rigid transforms in set() accumulate in
+	// rigidTransform, any other point change starts a new epoch. meshes
+	// remember the frame they were tesselated in and can then move their
+	// vertices instead of tesselating again.
+	static uint32_t nextRigidEpoch;
+	uint32_t rigidEpoch;
+	nsvg::Transform rigidTransform;
+
+	inline void newRigidEpoch() {
+		rigidEpoch = ++nextRigidEpoch;
+		if (rigidEpoch == 0) {
+			rigidEpoch = ++nextRigidEpoch;
+		}
+		rigidTransform = nsvg::Transform();
+	}
+
+	bool isRigid(const nsvg::Transform &transform) const;
+
+	void ensurePacked();
+	bool animatePacked(const GraphicsRef &a, const GraphicsRef &b, float t);
+
 	inline const PathRef &current() const {
 		return paths[paths.size() - 1];
 	}
@@ -232,12 +275,26 @@ public:
 	const float *getExactBounds();
 
 	void clean(float eps = 0.0);
+
+	// merges touching paths with the same opaque solid fill that are
+	// drawn right after each other, and removes paths hidden under
+	// opaque fills. merged paths are flattened by tess, so this is
+	// meant for static artwork.
+	ToveOptimizeStats optimize(AbstractTesselator &tess);
 	PathRef hit(float x, float y) const;
 
 	void setOrientation(ToveOrientation orientation);
 
 	void set(const GraphicsRef &source, const nsvg::Transform &transform);
 
+	inline uint32_t getRigidEpoch() const {
+		return rigidEpoch;
+	}
+
+	inline const nsvg::Transform &getRigidTransform() const {
+		return rigidTransform;
+	}
+
 	inline void changed(ToveChangeFlags flags) {
 		if (flags & (CHANGED_GEOMETRY | CHANGED_POINTS | CHANGED_BOUNDS)) {
 			flags |= CHANGED_BOUNDS | CHANGED_EXACT_BOUNDS;
@@ -245,6 +302,10 @@ public:
 		if (flags & (CHANGED_GEOMETRY | CHANGED_LINE_ARGS | CHANGED_FILL_ARGS)) {
 			flags |= CHANGED_PAINT_INDICES;
 		}
+		if ((flags & CHANGED_GEOMETRY) ||
+			((flags & CHANGED_POINTS) && !ObserverBatch::dispatchingRigid())) {
+			newRigidEpoch();
+		}
 		changes |= flags;
 	}
 
@@ -256,6 +317,7 @@ public:
 	void clearChanges(ToveChangeFlags flags);
 
 	void animate(const GraphicsRef &a, const GraphicsRef &b, float t);
+	void setPackedPoints(bool enabled);
 	static bool morphify(const std::vector<GraphicsRef> &graphics);
 	void rotate(ToveElementType what, int k);
 
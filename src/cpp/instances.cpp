@@ -0,0 +1,116 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#include "instances.h"
+#include <cstring>
+
+BEGIN_TOVE_NAMESPACE
+
+inline uint8_t toByte(float x) {
+	return uint8_t(std::max(0.0f, std::min(1.0f, x)) * 255.0f + 0.5f);
+}
+
+InstanceSet::InstanceSet() :
+	dirtyBegin(std::numeric_limits<int32_t>::max()),
+	dirtyEnd(0) {
+}
+
+void InstanceSet::updateTint(int i) {
+	const Paint &paint = paints[i];
+	uint8_t *tint = instances[i].tint;
+	tint[0] = toByte(paint.tint.r);
+	tint[1] = toByte(paint.tint.g);
+	tint[2] = toByte(paint.tint.b);
+	tint[3] = toByte(paint.tint.a * paint.opacity);
+	markDirty(i);
+}
+
+void InstanceSet::resize(int n) {
+	const int old = instances.size();
+	n = std::max(n, 0);
+
+	instances.resize(n);
+	paints.resize(n);
+
+	// new instances start out as identity transform, untinted, opaque.
+	for (int i = old; i < n; i++) {
+		ToveInstance &instance = instances[i];
+		instance.matrix[0] = 1;
+		instance.matrix[1] = 0;
+		instance.matrix[2] = 0;
+		instance.matrix[3] = 1;
+		instance.translation[0] = 0;
+		instance.translation[1] = 0;
+		paints[i] = Paint{ToveRGBA{1, 1, 1, 1}, 1};
+		updateTint(i);
+	}
+
+	// resizing usually means a new per-instance buffer on the GPU side,
+	// so everything needs to be copied again.
+	dirtyBegin = 0;
+	dirtyEnd = n;
+}
+
+bool InstanceSet::setTransform(int i,
+	float a, float b, float c, float d, float e, float f) {
+
+	if (i < 0 || i >= size()) {
+		return false;
+	}
+	ToveInstance &instance = instances[i];
+	instance.matrix[0] = a;
+	instance.matrix[1] = b;
+	instance.matrix[2] = c;
+	instance.matrix[3] = d;
+	instance.translation[0] = e;
+	instance.translation[1] = f;
+	markDirty(i);
+	return true;
+}
+
+bool InstanceSet::setTint(int i, float r, float g, float b, float a) {
+	if (i < 0 || i >= size()) {
+		return false;
+	}
+	paints[i].tint = ToveRGBA{r, g, b, a};
+	updateTint(i);
+	return true;
+}
+
+bool InstanceSet::setOpacity(int i, float opacity) {
+	if (i < 0 || i >= size()) {
+		return false;
+	}
+	paints[i].opacity = opacity;
+	updateTint(i);
+	return true;
+}
+
+ToveVertexRange InstanceSet::copyData(void *buffer, int32_t size) {
+	const int32_t n = std::min(dirtyEnd,
+		int32_t(size / sizeof(ToveInstance)));
+	if (dirtyBegin >= n) {
+		return ToveVertexRange{0, 0};
+	}
+
+	const ToveVertexRange range{dirtyBegin, n - dirtyBegin};
+	std::memcpy(
+		static_cast<ToveInstance*>(buffer) + range.first,
+		instances.data() + range.first,
+		range.count * sizeof(ToveInstance));
+
+	dirtyBegin = std::numeric_limits<int32_t>::max();
+	dirtyEnd = 0;
+
+	return range;
+}
+
+END_TOVE_NAMESPACE
@@ -0,0 +1,66 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_INSTANCES
+#define __TOVE_INSTANCES 1
+
+#include "common.h"
+#include <vector>
+
+BEGIN_TOVE_NAMESPACE
+
+// per-instance data (affine transform, tint, opacity) for drawing many
+// copies of one tesselated Graphics in one instanced draw call. the
+// buffer layout is ToveInstance, so it can be uploaded as is into a
+// per-instance vertex buffer.
+
+class InstanceSet {
+	struct Paint {
+		ToveRGBA tint;
+		float opacity;
+	};
+
+	std::vector<ToveInstance> instances;
+	std::vector<Paint> paints;
+
+	int32_t dirtyBegin;
+	int32_t dirtyEnd;
+
+	inline void markDirty(int i) {
+		dirtyBegin = std::min(dirtyBegin, int32_t(i));
+		dirtyEnd = std::max(dirtyEnd, int32_t(i + 1));
+	}
+
+	void updateTint(int i);
+
+public:
+	InstanceSet();
+
+	// marks all instances as changed.
+	void resize(int n);
+
+	inline int size() const {
+		return instances.size();
+	}
+
+	bool setTransform(int i,
+		float a, float b, float c, float d, float e, float f);
+	bool setTint(int i, float r, float g, float b, float a);
+	bool setOpacity(int i, float opacity);
+
+	// copies all instances changed since the last call into buffer
+	// (at their natural offsets) and returns the range copied.
+	ToveVertexRange copyData(void *buffer, int32_t size);
+};
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_INSTANCES
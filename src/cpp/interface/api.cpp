@@ -14,6 +14,11 @@
 #include "../path.h"
 #include "../graphics.h"
 #include "../palette.h"
+#include "../timeline.h"
+#include "../morph.h"
+#include "../instances.h"
+#include "../batch.h"
+#include "../accounting.h"
 #include "../mesh/mesh.h"
 #include "../mesh/meshifier.h"
 #include "../mesh/flatten.h"
@@ -54,6 +59,15 @@ static const ToveTesselationSettings *getDefaultQuality() {
 	return &defaultQuality;
 }
 
+static std::vector<GraphicsRef> derefGraphics(const ToveGraphicsRef *graphics, int n) {
+	std::vector<GraphicsRef> g;
+	g.reserve(n);
+	for (int i = 0; i < n; i++) {
+		g.push_back(deref(graphics[i]));
+	}
+	return g;
+}
+
 extern "C" {
 
 void SetReportFunction(ToveReportFunction f) {
@@ -64,6 +78,16 @@ void SetReportLevel(ToveReportLevel l) {
 	tove::report::config.level = l;
 }
 
+void BeginChangeBatch() {
+	ObserverBatch::begin();
+}
+
+void EndChangeBatch() {
+	if (ObserverBatch::active()) {
+		ObserverBatch::end();
+	}
+}
+
 
 TovePaletteRef NoPalette() {
 	return TovePaletteRef{nullptr};
@@ -521,6 +545,28 @@ bool PathIsInside(TovePathRef path, float x, float y) {
 	return deref(path)->isInside(x, y);
 }
 
+bool PathIntersects(TovePathRef path, const ToveBounds *view) {
+	return deref(path)->intersects(*view);
+}
+
+int PathGetNumClipIndices(TovePathRef path) {
+#ifdef NSVG_CLIP_PATHS
+	return deref(path)->getClipIndices().size();
+#else
+	return 0;
+#endif
+}
+
+int PathGetClipIndex(TovePathRef path, int i) {
+#ifdef NSVG_CLIP_PATHS
+	const auto &indices = deref(path)->getClipIndices();
+	if (i >= 0 && i < int(indices.size())) {
+		return indices[i];
+	}
+#endif
+	return -1;
+}
+
 void PathSet(
 	TovePathRef path,
 	TovePathRef source,
@@ -781,6 +827,15 @@ int GraphicsGetNumPaths(ToveGraphicsRef shape) {
 	return deref(shape)->getNumPaths();
 }
 
+int GraphicsGetNumClips(ToveGraphicsRef shape) {
+#ifdef NSVG_CLIP_PATHS
+	const ClipSetRef &clipSet = deref(shape)->getClipSet();
+	return clipSet ? clipSet->getClips().size() : 0;
+#else
+	return 0;
+#endif
+}
+
 TovePathRef GraphicsGetPath(ToveGraphicsRef shape, int i) {
 	if (i >= 1 && i <= deref(shape)->getNumPaths()) {
 		return paths.publish(deref(shape)->getPath(i - 1));
@@ -889,6 +944,10 @@ void GraphicsAnimate(
 	deref(graphics)->animate(deref(a), deref(b), t);
 }
 
+void GraphicsSetPackedPoints(ToveGraphicsRef graphics, bool packed) {
+	deref(graphics)->setPackedPoints(packed);
+}
+
 void GraphicsSetOrientation(
 	ToveGraphicsRef graphics,
 	ToveOrientation orientation) {
@@ -899,6 +958,12 @@ void GraphicsClean(ToveGraphicsRef graphics, float eps) {
 	deref(graphics)->clean(eps);
 }
 
+ToveOptimizeStats GraphicsOptimize(
+	ToveGraphicsRef graphics, ToveTesselatorRef tess) {
+
+	return deref(graphics)->optimize(*deref(tess).get());
+}
+
 TovePathRef GraphicsHit(ToveGraphicsRef graphics, float x, float y) {
 	return paths.publishOrNil(deref(graphics)->hit(x, y));
 }
@@ -932,12 +997,7 @@ void GraphicsSetLineCap(ToveGraphicsRef graphics, ToveLineCap cap) {
 }
 
 bool GraphicsMorphify(const ToveGraphicsRef *graphics, int n) {
-	std::vector<GraphicsRef> g;
-	g.reserve(n);
-	for (int i = 0; i < n; i++) {
-		g.push_back(deref(graphics[i]));
-	}
-	return Graphics::morphify(g);
+	return Graphics::morphify(derefGraphics(graphics, n));
 }
 
 void GraphicsRotate(ToveGraphicsRef graphics, ToveElementType what, int k) {
@@ -949,6 +1009,63 @@ void ReleaseGraphics(ToveGraphicsRef graphics) {
 }
 
 
+ToveTimelineRef NewTimeline(ToveInterpolation interpolation) {
+	return timelines.make(interpolation);
+}
+
+void TimelineAddKey(ToveTimelineRef timeline,
+	ToveGraphicsRef graphics, float time, ToveEasing ease) {
+	deref(timeline)->addKey(deref(graphics), time, ease);
+}
+
+float TimelineGetDuration(ToveTimelineRef timeline) {
+	return deref(timeline)->getDuration();
+}
+
+bool TimelineEvaluate(ToveTimelineRef timeline, float t, ToveGraphicsRef target) {
+	return deref(timeline)->evaluate(t, deref(target));
+}
+
+void ReleaseTimeline(ToveTimelineRef timeline) {
+	timelines.release(timeline);
+}
+
+
+ToveMorphPlanRef NewMorphPlan(const ToveGraphicsRef *graphics, int n) {
+	const MorphPlanRef plan = tove_make_shared<MorphPlan>();
+	if (!plan->analyze(derefGraphics(graphics, n))) {
+		return morphPlans.publishOrNil(MorphPlanRef());
+	}
+	return morphPlans.publish(plan);
+}
+
+ToveMorphPlanRef NewMorphPlanFromString(const char *s) {
+	const MorphPlanRef plan = tove_make_shared<MorphPlan>();
+	if (!plan->deserialize(s)) {
+		tove::report::warn("could not parse morph plan.");
+		return morphPlans.publishOrNil(MorphPlanRef());
+	}
+	return morphPlans.publish(plan);
+}
+
+bool MorphPlanApply(ToveMorphPlanRef plan, const ToveGraphicsRef *graphics, int n) {
+	return deref(plan)->apply(derefGraphics(graphics, n));
+}
+
+bool MorphPlanRotate(ToveMorphPlanRef plan, ToveGraphicsRef graphics,
+	int index, ToveElementType what, int k) {
+	return deref(plan)->rotate(deref(graphics), index, what, k);
+}
+
+const char *MorphPlanSerialize(ToveMorphPlanRef plan) {
+	return deref(plan)->serialize();
+}
+
+void ReleaseMorphPlan(ToveMorphPlanRef plan) {
+	morphPlans.release(plan);
+}
+
+
 ToveFeedRef NewColorFeed(ToveGraphicsRef graphics, float scale) {
 	return shaderLinks.publish(tove_make_shared<ColorFeed>(deref(graphics), scale));
 }
@@ -999,10 +1116,31 @@ int MeshGetVertexCount(ToveMeshRef mesh) {
 	return deref(mesh)->getVertexCount();
 }
 
+int MeshGetNumWeldedVertices(ToveMeshRef mesh) {
+	return deref(mesh)->getNumWeldedVertices();
+}
+
 void MeshSetVertexBuffer(ToveMeshRef mesh, void *buffer, int32_t size) {
 	deref(mesh)->setExternalVertexBuffer(buffer, size);
 }
 
+ToveVertexRange MeshFetchDirtyRange(ToveMeshRef mesh) {
+	return deref(mesh)->fetchDirtyRange();
+}
+
+int MeshGetVertexByteSize(ToveMeshRef mesh, ToveVertexFormat format) {
+	return deref(mesh)->getVertexByteSize(format);
+}
+
+ToveVertexQuantization MeshComputeQuantization(ToveMeshRef mesh) {
+	return deref(mesh)->computeQuantization();
+}
+
+bool MeshCopyVertexData(ToveMeshRef mesh, ToveVertexFormat format,
+	const ToveVertexQuantization *quantization, void *buffer, int32_t size) {
+	return deref(mesh)->copyVertexData(format, *quantization, buffer, size);
+}
+
 ToveTrianglesMode MeshGetIndexMode(ToveMeshRef mesh) {
 	return deref(mesh)->getIndexMode();
 }
@@ -1017,10 +1155,66 @@ void MeshCopyIndexData(ToveMeshRef mesh, void *buffer, int32_t size) {
 		size / sizeof(ToveVertexIndex));
 }
 
+void MeshSetOptimizeIndices(ToveMeshRef mesh, bool optimize) {
+	deref(mesh)->setOptimizeIndices(optimize);
+}
+
+ToveMeshUpdateFlags MeshSwapPendingTriangulations(ToveMeshRef mesh) {
+	return deref(mesh)->swapPendingTriangulations();
+}
+
+int MeshGetNumLODs(ToveMeshRef mesh) {
+	return deref(mesh)->getNumLODs();
+}
+
+ToveIndexRange MeshGetLODIndexRange(ToveMeshRef mesh, int lod) {
+	return deref(mesh)->getLODIndexRange(lod);
+}
+
+ToveIndexRange MeshGetPathIndexRange(ToveMeshRef mesh, int pathIndex) {
+	return deref(mesh)->getPathIndexRange(pathIndex);
+}
+
 void MeshCacheKeyFrame(ToveMeshRef mesh) {
 	deref(mesh)->cacheKeyFrame();
 }
 
+const char *MeshSerializeTriangulations(ToveMeshRef mesh) {
+	return deref(mesh)->serializeTriangulations();
+}
+
+bool MeshDeserializeTriangulations(ToveMeshRef mesh, const char *s) {
+	return deref(mesh)->deserializeTriangulations(s);
+}
+
+void MeshSetTriangleCacheBudget(ToveMeshRef mesh, uint64_t bytes) {
+	deref(mesh)->setTriangleCacheBudget(bytes);
+}
+
+ToveTriangleCacheStats MeshGetTriangleCacheStats(ToveMeshRef mesh) {
+	return deref(mesh)->getTriangleCacheStats();
+}
+
+void SetTriangleCacheBudget(uint64_t bytes) {
+	TriangleCache::getGlobalBudget().stats.budget = bytes;
+}
+
+ToveTriangleCacheStats GetTriangleCacheStats() {
+	return TriangleCache::getGlobalBudget().stats;
+}
+
+ToveMemoryStats MeshGetMemoryUsage(ToveMeshRef mesh) {
+	return deref(mesh)->getMemoryUsage();
+}
+
+void SetMemoryBudget(uint64_t bytes) {
+	memory::budget = bytes;
+}
+
+ToveMemoryStats GetMemoryUsage() {
+	return memory::getStats();
+}
+
 void MeshSetCacheSize(ToveMeshRef mesh, int size) {
 	deref(mesh)->setCacheSize(size);
 }
@@ -1029,21 +1223,136 @@ void ReleaseMesh(ToveMeshRef mesh) {
 	meshes.release(mesh);
 }
 
+
+ToveInstanceSetRef NewInstanceSet() {
+	return instanceSets.make();
+}
+
+void InstanceSetResize(ToveInstanceSetRef set, int n) {
+	deref(set)->resize(n);
+}
+
+int InstanceSetGetSize(ToveInstanceSetRef set) {
+	return deref(set)->size();
+}
+
+bool InstanceSetSetTransform(ToveInstanceSetRef set, int i,
+	float a, float b, float c, float d, float e, float f) {
+	return deref(set)->setTransform(i, a, b, c, d, e, f);
+}
+
+bool InstanceSetSetTint(ToveInstanceSetRef set, int i,
+	float r, float g, float b, float a) {
+	return deref(set)->setTint(i, r, g, b, a);
+}
+
+bool InstanceSetSetOpacity(ToveInstanceSetRef set, int i, float opacity) {
+	return deref(set)->setOpacity(i, opacity);
+}
+
+ToveVertexRange InstanceSetCopyData(
+	ToveInstanceSetRef set, void *buffer, int32_t size) {
+	return deref(set)->copyData(buffer, size);
+}
+
+void ReleaseInstanceSet(ToveInstanceSetRef set) {
+	instanceSets.release(set);
+}
+
+
+ToveMeshBatchRef NewMeshBatch() {
+	return meshBatches.make();
+}
+
+int MeshBatchAdd(ToveMeshBatchRef batch, ToveMeshRef mesh) {
+	return deref(batch)->add(deref(mesh));
+}
+
+bool MeshBatchRemove(ToveMeshBatchRef batch, int i) {
+	return deref(batch)->remove(i);
+}
+
+int MeshBatchGetSize(ToveMeshBatchRef batch) {
+	return deref(batch)->size();
+}
+
+bool MeshBatchSetTransform(ToveMeshBatchRef batch, int i,
+	float a, float b, float c, float d, float e, float f) {
+	return deref(batch)->setTransform(i, a, b, c, d, e, f);
+}
+
+void MeshBatchChanged(ToveMeshBatchRef batch, int i,
+	ToveMeshUpdateFlags flags) {
+	deref(batch)->changed(i, flags);
+}
+
+ToveMeshUpdateFlags MeshBatchFetchUpdates(ToveMeshBatchRef batch) {
+	return deref(batch)->fetchUpdates();
+}
+
+int MeshBatchGetVertexCount(ToveMeshBatchRef batch) {
+	return deref(batch)->getVertexCount();
+}
+
+int MeshBatchGetIndexCount(ToveMeshBatchRef batch) {
+	return deref(batch)->getIndexCount();
+}
+
+ToveIndexRange MeshBatchGetMemberIndexRange(ToveMeshBatchRef batch, int i) {
+	return deref(batch)->getMemberIndexRange(i);
+}
+
+ToveVertexRange MeshBatchCopyVertexData(
+	ToveMeshBatchRef batch, void *buffer, int32_t size) {
+	return deref(batch)->copyVertexData(buffer, size);
+}
+
+void MeshBatchCopyIndexData(
+	ToveMeshBatchRef batch, uint32_t *indices, int32_t count) {
+	deref(batch)->copyIndexData(indices, count);
+}
+
+void ReleaseMeshBatch(ToveMeshBatchRef batch) {
+	meshBatches.release(batch);
+}
+
 ToveTesselatorRef NewAdaptiveTesselator(float resolution, int recursionLimit) {
 	return tesselators.publish(tove_make_shared<AdaptiveTesselator>(
 		new AdaptiveFlattener<DefaultCurveFlattener>(
 			DefaultCurveFlattener(resolution, recursionLimit))));
 }
 
+ToveTesselatorRef NewAdaptiveLODTesselator(
+	float resolution, int recursionLimit, int levels) {
+	return tesselators.publish(tove_make_shared<AdaptiveTesselator>(
+		new AdaptiveFlattener<DefaultCurveFlattener>(
+			DefaultCurveFlattener(resolution, recursionLimit)), levels));
+}
+
 ToveTesselatorRef NewRigidTesselator(int subdivisions) {
 	return tesselators.publish(tove_make_shared<RigidTesselator>(subdivisions));
 }
 
+void TesselatorSetViewScale(ToveTesselatorRef tess,
+	float scale, float minPathSize) {
+	deref(tess)->setViewScale(scale, minPathSize);
+}
+
+void TesselatorSetOcclusionCulling(ToveTesselatorRef tess, bool enabled) {
+	deref(tess)->setOcclusionCulling(enabled);
+}
+
+void TesselatorSetAsyncTriangulation(ToveTesselatorRef tess, bool enabled) {
+	deref(tess)->setAsyncTriangulation(enabled);
+}
+
 ToveMeshUpdateFlags TesselatorTessGraphics(ToveTesselatorRef tess,
-	ToveGraphicsRef graphics, ToveMeshRef mesh, ToveMeshUpdateFlags flags) {
+	ToveGraphicsRef graphics, ToveMeshRef mesh, ToveMeshUpdateFlags flags,
+	const ToveBounds *view) {
 
 	tove::MeshRef m = deref(mesh);
-	return deref(tess)->graphicsToMesh(deref(graphics).get(), flags, m, m);
+	return deref(tess)->graphicsToMesh(
+		deref(graphics).get(), flags, m, m, view);
 }
 
 ToveMeshUpdateFlags TesselatorTessPath(ToveTesselatorRef tess,
@@ -1074,6 +1383,13 @@ void TesselatorSetMaxSubdivisions(int subdivisions) {
 	toveMaxFlattenSubdivisions = subdivisions;
 }
 
+void TesselatorTessClip(ToveTesselatorRef tess,
+	ToveGraphicsRef graphics, int clipIndex, ToveMeshRef mesh) {
+
+	deref(tess)->clipToMesh(
+		deref(graphics).get(), clipIndex, deref(mesh));
+}
+
 bool TesselatorHasFixedSize(ToveTesselatorRef tess) {
 	return deref(tess)->hasFixedSize();
 }
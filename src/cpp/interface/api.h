@@ -1,6 +1,8 @@
 EXPORT const char *GetVersion();
 EXPORT void SetReportFunction(ToveReportFunction f);
 EXPORT void SetReportLevel(ToveReportLevel l);
+EXPORT void BeginChangeBatch();
+EXPORT void EndChangeBatch();
 
 EXPORT TovePaletteRef NoPalette();
 EXPORT TovePaletteRef DefaultPalette(const char *name);
@@ -96,6 +98,9 @@ EXPORT void PathSetOpacity(TovePathRef path, float opacity);
 EXPORT void PathSetOrientation(TovePathRef path, ToveOrientation orientation);
 EXPORT void PathClean(TovePathRef path, float eps);
 EXPORT bool PathIsInside(TovePathRef path, float x, float y);
+EXPORT bool PathIntersects(TovePathRef path, const ToveBounds *view);
+EXPORT int PathGetNumClipIndices(TovePathRef path);
+EXPORT int PathGetClipIndex(TovePathRef path, int i);
 EXPORT void PathSet(TovePathRef path, TovePathRef source,
 	bool scaleLineWidth, float a, float b, float c, float d, float e, float f);
 EXPORT ToveLineJoin PathGetLineJoin(TovePathRef path);
@@ -119,6 +124,7 @@ EXPORT TovePathRef GraphicsGetCurrentPath(ToveGraphicsRef shape);
 EXPORT void GraphicsAddPath(ToveGraphicsRef shape, TovePathRef path);
 EXPORT void GraphicsRemovePath(ToveGraphicsRef shape, TovePathRef path);
 EXPORT int GraphicsGetNumPaths(ToveGraphicsRef shape);
+EXPORT int GraphicsGetNumClips(ToveGraphicsRef shape);
 EXPORT TovePathRef GraphicsGetPath(ToveGraphicsRef shape, int i);
 EXPORT TovePathRef GraphicsGetPathByName(ToveGraphicsRef shape, const char *name);
 EXPORT ToveChangeFlags GraphicsFetchChanges(ToveGraphicsRef shape, ToveChangeFlags flags);
@@ -137,8 +143,11 @@ EXPORT void GraphicsRasterize(ToveGraphicsRef shape, uint8_t *pixels,
 	int width, int height, int stride, float tx, float ty, float scale,
 	const ToveRasterizeSettings *settings);
 EXPORT void GraphicsAnimate(ToveGraphicsRef shape, ToveGraphicsRef a, ToveGraphicsRef b, float t);
+EXPORT void GraphicsSetPackedPoints(ToveGraphicsRef graphics, bool packed);
 EXPORT void GraphicsSetOrientation(ToveGraphicsRef shape, ToveOrientation orientation);
 EXPORT void GraphicsClean(ToveGraphicsRef shape, float eps);
+EXPORT ToveOptimizeStats GraphicsOptimize(
+	ToveGraphicsRef shape, ToveTesselatorRef tess);
 EXPORT TovePathRef GraphicsHit(ToveGraphicsRef graphics, float x, float y);
 EXPORT void GraphicsClear(ToveGraphicsRef graphics);
 EXPORT bool GraphicsAreColorsSolid(ToveGraphicsRef shape);
@@ -149,6 +158,21 @@ EXPORT bool GraphicsMorphify(const ToveGraphicsRef *graphics, int n);
 EXPORT void GraphicsRotate(ToveGraphicsRef graphics, ToveElementType what, int k);
 EXPORT void ReleaseGraphics(ToveGraphicsRef shape);
 
+EXPORT ToveTimelineRef NewTimeline(ToveInterpolation interpolation);
+EXPORT void TimelineAddKey(ToveTimelineRef timeline,
+	ToveGraphicsRef graphics, float time, ToveEasing ease);
+EXPORT float TimelineGetDuration(ToveTimelineRef timeline);
+EXPORT bool TimelineEvaluate(ToveTimelineRef timeline, float t, ToveGraphicsRef target);
+EXPORT void ReleaseTimeline(ToveTimelineRef timeline);
+
+EXPORT ToveMorphPlanRef NewMorphPlan(const ToveGraphicsRef *graphics, int n);
+EXPORT ToveMorphPlanRef NewMorphPlanFromString(const char *s);
+EXPORT bool MorphPlanApply(ToveMorphPlanRef plan, const ToveGraphicsRef *graphics, int n);
+EXPORT bool MorphPlanRotate(ToveMorphPlanRef plan, ToveGraphicsRef graphics,
+	int index, ToveElementType what, int k);
+EXPORT const char *MorphPlanSerialize(ToveMorphPlanRef plan);
+EXPORT void ReleaseMorphPlan(ToveMorphPlanRef plan);
+
 EXPORT ToveFeedRef NewColorFeed(ToveGraphicsRef graphics, float scale);
 EXPORT ToveFeedRef NewGeometryFeed(TovePathRef path, bool enableFragmentShaderStrokes);
 EXPORT ToveChangeFlags FeedBeginUpdate(ToveFeedRef link);
@@ -162,31 +186,91 @@ EXPORT ToveMeshRef NewMesh(ToveNameRef name);
 EXPORT ToveMeshRef NewColorMesh(ToveNameRef name);
 EXPORT ToveMeshRef NewPaintMesh(ToveNameRef name);
 EXPORT int MeshGetVertexCount(ToveMeshRef mesh);
+EXPORT int MeshGetNumWeldedVertices(ToveMeshRef mesh);
 EXPORT void MeshSetVertexBuffer(
 	ToveMeshRef mesh, void *buffer, int32_t size);
+EXPORT ToveVertexRange MeshFetchDirtyRange(ToveMeshRef mesh);
+EXPORT int MeshGetVertexByteSize(ToveMeshRef mesh, ToveVertexFormat format);
+EXPORT ToveVertexQuantization MeshComputeQuantization(ToveMeshRef mesh);
+EXPORT bool MeshCopyVertexData(ToveMeshRef mesh, ToveVertexFormat format,
+	const ToveVertexQuantization *quantization, void *buffer, int32_t size);
 EXPORT ToveTrianglesMode MeshGetIndexMode(ToveMeshRef mesh);
 EXPORT int MeshGetIndexCount(ToveMeshRef mesh);
 EXPORT void MeshCopyIndexData(
 	ToveMeshRef mesh, void *buffer, int32_t size);
+EXPORT void MeshSetOptimizeIndices(ToveMeshRef mesh, bool optimize);
+EXPORT ToveMeshUpdateFlags MeshSwapPendingTriangulations(ToveMeshRef mesh);
+EXPORT int MeshGetNumLODs(ToveMeshRef mesh);
+EXPORT ToveIndexRange MeshGetLODIndexRange(ToveMeshRef mesh, int lod);
+EXPORT ToveIndexRange MeshGetPathIndexRange(ToveMeshRef mesh, int pathIndex);
 EXPORT void MeshCacheKeyFrame(ToveMeshRef mesh);
+EXPORT const char *MeshSerializeTriangulations(ToveMeshRef mesh);
+EXPORT bool MeshDeserializeTriangulations(ToveMeshRef mesh, const char *s);
+EXPORT void MeshSetTriangleCacheBudget(ToveMeshRef mesh, uint64_t bytes);
+EXPORT ToveTriangleCacheStats MeshGetTriangleCacheStats(ToveMeshRef mesh);
+EXPORT void SetTriangleCacheBudget(uint64_t bytes);
+EXPORT ToveTriangleCacheStats GetTriangleCacheStats();
+EXPORT ToveMemoryStats MeshGetMemoryUsage(ToveMeshRef mesh);
+EXPORT void SetMemoryBudget(uint64_t bytes);
+EXPORT ToveMemoryStats GetMemoryUsage();
 EXPORT void MeshSetCacheSize(ToveMeshRef mesh, int size);
 EXPORT void ReleaseMesh(ToveMeshRef mesh);
 
+EXPORT ToveInstanceSetRef NewInstanceSet();
+EXPORT void InstanceSetResize(ToveInstanceSetRef set, int n);
+EXPORT int InstanceSetGetSize(ToveInstanceSetRef set);
+EXPORT bool InstanceSetSetTransform(ToveInstanceSetRef set, int i,
+	float a, float b, float c, float d, float e, float f);
+EXPORT bool InstanceSetSetTint(ToveInstanceSetRef set, int i,
+	float r, float g, float b, float a);
+EXPORT bool InstanceSetSetOpacity(ToveInstanceSetRef set, int i, float opacity);
+EXPORT ToveVertexRange InstanceSetCopyData(
+	ToveInstanceSetRef set, void *buffer, int32_t size);
+EXPORT void ReleaseInstanceSet(ToveInstanceSetRef set);
+
+EXPORT ToveMeshBatchRef NewMeshBatch();
+EXPORT int MeshBatchAdd(ToveMeshBatchRef batch, ToveMeshRef mesh);
+EXPORT bool MeshBatchRemove(ToveMeshBatchRef batch, int i);
+EXPORT int MeshBatchGetSize(ToveMeshBatchRef batch);
+EXPORT bool MeshBatchSetTransform(ToveMeshBatchRef batch, int i,
+	float a, float b, float c, float d, float e, float f);
+EXPORT void MeshBatchChanged(ToveMeshBatchRef batch, int i,
+	ToveMeshUpdateFlags flags);
+EXPORT ToveMeshUpdateFlags MeshBatchFetchUpdates(ToveMeshBatchRef batch);
+EXPORT int MeshBatchGetVertexCount(ToveMeshBatchRef batch);
+EXPORT int MeshBatchGetIndexCount(ToveMeshBatchRef batch);
+EXPORT ToveIndexRange MeshBatchGetMemberIndexRange(ToveMeshBatchRef batch, int i);
+EXPORT ToveVertexRange MeshBatchCopyVertexData(
+	ToveMeshBatchRef batch, void *buffer, int32_t size);
+EXPORT void MeshBatchCopyIndexData(
+	ToveMeshBatchRef batch, uint32_t *indices, int32_t count);
+EXPORT void ReleaseMeshBatch(ToveMeshBatchRef batch);
+
 EXPORT void ConfigureShaderCode(ToveShaderLanguage language, int matrixRows);
 EXPORT const char *GetPaintShaderCode(int numPaints, int numGradients);
+EXPORT const char *GetInstanceShaderCode();
 
 EXPORT ToveShaderCode GetGPUXFillShaderCode(
 	const ToveShaderData *data, bool fragLine, bool meshBand, bool debug);
 EXPORT ToveShaderCode GetGPUXLineShaderCode(const ToveShaderData *data);
 
 EXPORT ToveTesselatorRef NewAdaptiveTesselator(float resolution, int recursionLimit);
+EXPORT ToveTesselatorRef NewAdaptiveLODTesselator(
+	float resolution, int recursionLimit, int levels);
 EXPORT ToveTesselatorRef NewRigidTesselator(int subdivisions);
 EXPORT ToveTesselatorRef NewAntiGrainTesselator(const AntiGrainSettings *settings);
+EXPORT void TesselatorSetViewScale(ToveTesselatorRef tess,
+	float scale, float minPathSize);
+EXPORT void TesselatorSetOcclusionCulling(ToveTesselatorRef tess, bool enabled);
+EXPORT void TesselatorSetAsyncTriangulation(ToveTesselatorRef tess, bool enabled);
 EXPORT ToveMeshUpdateFlags TesselatorTessGraphics(ToveTesselatorRef tess,
-	ToveGraphicsRef graphics, ToveMeshRef mesh, ToveMeshUpdateFlags flags);
+	ToveGraphicsRef graphics, ToveMeshRef mesh, ToveMeshUpdateFlags flags,
+	const ToveBounds *view);
 EXPORT ToveMeshUpdateFlags TesselatorTessPath(ToveTesselatorRef tess,
 	ToveGraphicsRef graphics, TovePathRef path,
 	ToveMeshRef fillMesh, ToveMeshRef lineMesh, ToveMeshUpdateFlags flags);
+EXPORT void TesselatorTessClip(ToveTesselatorRef tess,
+	ToveGraphicsRef graphics, int clipIndex, ToveMeshRef mesh);
 EXPORT void TesselatorSetMaxSubdivisions(int subdivisions);
 EXPORT bool TesselatorHasFixedSize(ToveTesselatorRef tess);
 EXPORT void ReleaseTesselator(ToveTesselatorRef tess);
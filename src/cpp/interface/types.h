@@ -82,6 +82,22 @@ typedef enum {
 	TOVE_HANDLE_ALIGNED
 } ToveHandle;
 
+typedef enum {
+	TOVE_EASE_LINEAR,
+	TOVE_EASE_NONE,
+	TOVE_EASE_IN_QUAD,
+	TOVE_EASE_OUT_QUAD,
+	TOVE_EASE_IN_OUT_QUAD,
+	TOVE_EASE_IN_CUBIC,
+	TOVE_EASE_OUT_CUBIC,
+	TOVE_EASE_IN_OUT_CUBIC
+} ToveEasing;
+
+typedef enum {
+	TOVE_INTERPOLATE_LINEAR,
+	TOVE_INTERPOLATE_CATMULL_ROM
+} ToveInterpolation;
+
 enum {
 	CHANGED_FILL_STYLE = 1,
 	CHANGED_LINE_STYLE = 2,
@@ -104,6 +120,7 @@ enum {
 	UPDATE_MESH_TRIANGLES = 4,
 	UPDATE_MESH_GEOMETRY = 8,
 	UPDATE_MESH_EVERYTHING = 15,
+	UPDATE_MESH_VIEW = 16,
 	UPDATE_MESH_AUTO_TRIANGLES = 128
 };
 
@@ -111,6 +128,62 @@ typedef struct {
 	float x, y;
 } TovePoint;
 
+typedef struct {
+	int32_t first;
+	int32_t count;
+} ToveVertexRange;
+
+typedef struct {
+	int32_t first;
+	int32_t count;
+} ToveIndexRange;
+
+typedef struct {
+	int32_t numPathsBefore;
+	int32_t numPathsAfter;
+	int32_t numOccluded;
+	int32_t numMerged;
+	int32_t numVerticesBefore;
+	int32_t numVerticesAfter;
+} ToveOptimizeStats;
+
+typedef struct {
+	// bytes used by cached triangulations, and the limit (0 if none).
+	uint64_t bytes;
+	uint64_t budget;
+	int32_t numTriangulations;
+	// evictions in total, and those due to exceeding the budget.
+	int32_t numEvicted;
+	int32_t numEvictedOverBudget;
+} ToveTriangleCacheStats;
+
+typedef struct {
+	// bytes held by vertex buffers of meshes, triangle caches, buffers
+	// for cleaning subpaths, shader geometry data, gradients and nsvg's
+	// parser and rasterizer.
+	uint64_t meshes;
+	uint64_t triangles;
+	uint64_t cleaners;
+	uint64_t geometry;
+	uint64_t gradients;
+	uint64_t parser;
+	// sum of the above, and the limit that triggers cache eviction (0 if none).
+	uint64_t total;
+	uint64_t budget;
+} ToveMemoryStats;
+
+typedef enum {
+	TOVE_VERTEX_FLOAT32,
+	TOVE_VERTEX_UNORM16,
+	TOVE_VERTEX_FLOAT16
+} ToveVertexFormat;
+
+typedef struct {
+	// compact positions are stored as (p - (x0, y0)) * scale.
+	float x0, y0;
+	float scale;
+} ToveVertexQuantization;
+
 typedef struct {
 	void *ptr;
 } TovePaintRef;
@@ -143,6 +216,28 @@ typedef struct {
 	void *ptr;
 } ToveNameRef;
 
+typedef struct {
+	void *ptr;
+} ToveTimelineRef;
+
+typedef struct {
+	void *ptr;
+} ToveMorphPlanRef;
+
+typedef struct {
+	void *ptr;
+} ToveInstanceSetRef;
+
+typedef struct {
+	void *ptr;
+} ToveMeshBatchRef;
+
+typedef struct {
+	float matrix[4]; // a, b, c, d
+	float translation[2]; // e, f
+	uint8_t tint[4]; // rgba, alpha includes opacity
+} ToveInstance;
+
 typedef enum {
 	TOVE_REC_DEPTH,
 	TOVE_ANTIGRAIN,
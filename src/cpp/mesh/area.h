@@ -76,27 +76,26 @@ public:
 	void clear() {
 		indices.clear();
 	}
-};
-
-// fast, SIMD-able computation of areas
-// (clang does a good job of SIMD-ing this)
 
-class NonVanishingAreas {
-	const float eps;
-	uint8_t * const result;
+	inline size_t getByteSize() const {
+		return indices.capacity() * sizeof(ToveVertexIndex);
+	}
 
-public:
-	inline NonVanishingAreas(
-		uint8_t *result, float eps) :
-		result(result), eps(eps) {
+	// clears, and frees our buffer if it holds more than maxBytes.
+	inline void trim(size_t maxBytes) {
+		indices.clear();
+		if (getByteSize() > maxBytes) {
+			std::vector<ToveVertexIndex>().swap(indices);
+		}
 	}
 
-	inline void operator()(int i, float area) const {
-		result[i] = std::abs(area) > eps;
+	inline void serialize(std::ostream &out) const {
+		writeIndices(out, indices.data(), indices.size());
 	}
 
-	inline bool done() const {
-		return false;
+	inline bool deserialize(std::istream &in, int numVertices) {
+		return readIndices(in, indices, numVertices) &&
+			indices.size() % 3 == 0;
 	}
 };
 
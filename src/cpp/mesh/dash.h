@@ -0,0 +1,142 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_MESH_DASH
+#define __TOVE_MESH_DASH 1
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "../common.h"
+
+BEGIN_TOVE_NAMESPACE
+
+// cumulative arc lengths of a polyline, so that the point at a given
+// arc length is found through a binary search.
+
+class ArcLengthIndex {
+	const ClipperPath &points;
+	std::vector<double> lengths;
+
+	inline int segment(double s) const {
+		const int i = int(std::upper_bound(
+			lengths.begin(), lengths.end(), s) - lengths.begin()) - 1;
+		return std::max(0, std::min(i, int(lengths.size()) - 2));
+	}
+
+	inline ClipperPoint at(int i, double s) const {
+		const double l0 = lengths[i];
+		const double l1 = lengths[i + 1];
+		const double t = l1 > l0 ? (s - l0) / (l1 - l0) : 0.0;
+		const ClipperPoint &a = points[i];
+		const ClipperPoint &b = points[i + 1];
+		return ClipperPoint(
+			ClipperLib::cInt(std::round(a.X + (b.X - a.X) * t)),
+			ClipperLib::cInt(std::round(a.Y + (b.Y - a.Y) * t)));
+	}
+
+	static inline void append(ClipperPath &path, const ClipperPoint &p) {
+		if (path.empty() || path.back() != p) {
+			path.push_back(p);
+		}
+	}
+
+public:
+	ArcLengthIndex(const ClipperPath &points) : points(points) {
+		const int n = points.size();
+		lengths.reserve(n);
+		double length = 0.0;
+		for (int i = 0; i < n; i++) {
+			if (i > 0) {
+				const double dx = double(points[i].X - points[i - 1].X);
+				const double dy = double(points[i].Y - points[i - 1].Y);
+				length += std::sqrt(dx * dx + dy * dy);
+			}
+			lengths.push_back(length);
+		}
+	}
+
+	inline double length() const {
+		return lengths.empty() ? 0.0 : lengths.back();
+	}
+
+	// appends the part of the polyline between arc lengths s0 and s1.
+	void extract(double s0, double s1, ClipperPath &out) const {
+		const int i = segment(s0);
+		const int j = segment(s1);
+		append(out, at(i, s0));
+		for (int k = i + 1; k <= j; k++) {
+			append(out, points[k]);
+		}
+		append(out, at(j, s1));
+	}
+};
+
+// splits a polyline into dashes. the pattern is shifted by offset, so
+// that animating the offset moves the dashes along the line.
+
+inline void dashPolyline(
+	const ClipperPath &line,
+	const std::vector<double> &pattern,
+	double offset,
+	ClipperPaths &dashes) {
+
+	const ArcLengthIndex index(line);
+	const double length = index.length();
+	if (length <= 0.0) {
+		return;
+	}
+
+	double period = 0.0;
+	for (double d : pattern) {
+		period += d;
+	}
+	if (period <= 0.0) {
+		dashes.push_back(line);
+		return;
+	}
+
+	double phase = std::fmod(offset, period);
+	if (phase < 0.0) {
+		phase += period;
+	}
+
+	const int n = pattern.size();
+	int k = 0;
+	// zero length dashes right at the start are not skipped.
+	for (int i = 0; i < n && (phase > pattern[k] ||
+		(phase == pattern[k] && pattern[k] > 0.0)); i++) {
+		phase -= pattern[k];
+		k = (k + 1) % n;
+	}
+
+	double s = 0.0;
+	double remaining = std::max(0.0, pattern[k] - phase);
+	while (s < length) {
+		const double e = std::min(length, s + remaining);
+		if ((k & 1) == 0) {
+			// zero length dashes still get caps in SVG, so they stay
+			// as single points.
+			ClipperPath dash;
+			index.extract(s, e, dash);
+			if (!dash.empty()) {
+				dashes.push_back(std::move(dash));
+			}
+		}
+		s = e;
+		k = (k + 1) % n;
+		remaining = pattern[k];
+	}
+}
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_MESH_DASH
@@ -0,0 +1,132 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_MESH_DECIMATE
+#define __TOVE_MESH_DECIMATE 1
+
+#include <vector>
+#include <cmath>
+#include "utils.h"
+
+BEGIN_TOVE_NAMESPACE
+
+// hierarchical douglas-peucker decimation of flattened polylines. the
+// hierarchy is computed once; each point gets the tolerance up to which
+// it survives, so that decimating to any tolerance is one linear pass.
+
+class PolylineHierarchy {
+	const ClipperPaths &polylines;
+	std::vector<std::vector<float>> importance;
+
+	struct Span {
+		int i, j;
+		float bound;
+	};
+
+	static double distance(
+		const ClipperPoint &p,
+		const ClipperPoint &a,
+		const ClipperPoint &b) {
+
+		const double dx = double(b.X - a.X);
+		const double dy = double(b.Y - a.Y);
+		const double px = double(p.X - a.X);
+		const double py = double(p.Y - a.Y);
+		const double d2 = dx * dx + dy * dy;
+
+		if (d2 <= 0.0) {
+			return std::sqrt(px * px + py * py);
+		}
+
+		const double t = std::max(0.0, std::min(1.0, (px * dx + py * dy) / d2));
+		const double ex = px - t * dx;
+		const double ey = py - t * dy;
+		return std::sqrt(ex * ex + ey * ey);
+	}
+
+	static void compute(const ClipperPath &path, std::vector<float> &result) {
+		const int n = path.size();
+		result.assign(n, 0.0f);
+		if (n < 1) {
+			return;
+		}
+
+		const float inf = std::numeric_limits<float>::infinity();
+		result[0] = inf;
+		result[n - 1] = inf;
+
+		// a point never outlives its parent span, which keeps the levels
+		// nested.
+		std::vector<Span> stack;
+		stack.push_back(Span{0, n - 1, inf});
+
+		while (!stack.empty()) {
+			const Span span = stack.back();
+			stack.pop_back();
+
+			if (span.j - span.i < 2) {
+				continue;
+			}
+
+			const ClipperPoint &a = path[span.i];
+			const ClipperPoint &b = path[span.j];
+			int k = span.i + 1;
+			double d = -1.0;
+			for (int m = span.i + 1; m < span.j; m++) {
+				const double dm = distance(path[m], a, b);
+				if (dm > d) {
+					d = dm;
+					k = m;
+				}
+			}
+
+			const float bound = std::min(float(d), span.bound);
+			result[k] = bound;
+			stack.push_back(Span{span.i, k, bound});
+			stack.push_back(Span{k, span.j, bound});
+		}
+	}
+
+public:
+	PolylineHierarchy(const ClipperPaths &polylines) :
+		polylines(polylines) {
+
+		importance.resize(polylines.size());
+		for (size_t i = 0; i < polylines.size(); i++) {
+			compute(polylines[i], importance[i]);
+		}
+	}
+
+	void decimate(float tolerance, ClipperPaths &out) const {
+		out.clear();
+		out.reserve(polylines.size());
+
+		for (size_t i = 0; i < polylines.size(); i++) {
+			const ClipperPath &path = polylines[i];
+			const std::vector<float> &keep = importance[i];
+
+			ClipperPath decimated;
+			for (size_t j = 0; j < path.size(); j++) {
+				if (keep[j] >= tolerance) {
+					decimated.push_back(path[j]);
+				}
+			}
+
+			if (decimated.size() >= 2) {
+				out.push_back(std::move(decimated));
+			}
+		}
+	}
+};
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_MESH_DECIMATE
@@ -13,7 +13,8 @@
 #include <cmath>
 #include "mesh.h"
 #include "../utils.h"
-#include "turtle.h"
+#include "dash.h"
+#include "stroke.h"
 #include "../path.h"
 #include "../subpath.h"
 
@@ -43,15 +44,23 @@ ClipperParameters DefaultCurveFlattener::configure(float scale) {
 
 	const float eps = e * clipperScale;
 	tolerance = eps * eps;
+	pathRecursionLimit = recursionLimit;
 	return ClipperParameters{clipperScale, eps};
 }
 
+void DefaultCurveFlattener::configurePath(float pixelSize) {
+	// each subdivision level halves segments; stop where segments
+	// would get smaller than a pixel.
+	const int limit = int(std::ceil(std::log2(std::max(pixelSize, 1.0f)))) + 1;
+	pathRecursionLimit = std::min(recursionLimit, limit);
+}
+
 void DefaultCurveFlattener::flatten(
 	float x1, float y1, float x2, float y2,
 	float x3, float y3, float x4, float y4,
 	ClipperPath &points, int level) const {
 
-	if (level > recursionLimit) {
+	if (level > pathRecursionLimit) {
 		points.push_back(ClipperPoint(x4, y4));
 		return;
 	}
@@ -319,26 +328,23 @@ ClipperPaths AbstractAdaptiveFlattener::computeDashes(
 		return lines;
 	}
 
-	ClipperPaths dashes;
-	const float *dashArray = shape->strokeDashArray;
-
-	float dashLength = 0.0;
+	// dash lengths are given in path units, lines are in clipper units.
+	// odd patterns repeat twice, so that even entries are always dashes.
+	std::vector<double> pattern;
+	pattern.reserve(dashCount * 2);
 	for (int i = 0; i < dashCount; i++) {
-		dashLength += dashArray[i];
+		pattern.push_back(shape->strokeDashArray[i] * clipper.scale);
+	}
+	if (dashCount % 2) {
+		pattern.insert(pattern.end(), pattern.begin(), pattern.end());
 	}
 
-	for (int i = 0; i < lines.size(); i++) {
-		const ClipperPath &path = lines[i];
-		if (path.size() < 2) {
-			continue;
-		}
-
-		Turtle turtle(path, shape->strokeDashOffset, dashes);
-		int dashIndex = 0;
+	const double offset = shape->strokeDashOffset * clipper.scale;
 
-		while (turtle.push(dashArray[dashIndex])) {
-			turtle.toggle();
-			dashIndex = (dashIndex + 1) % dashCount;
+	ClipperPaths dashes;
+	for (const ClipperPath &line : lines) {
+		if (line.size() >= 2) {
+			dashPolyline(line, pattern, offset, dashes);
 		}
 	}
 
@@ -372,18 +378,51 @@ inline ClipperLib::EndType endType(int t, bool closed) {
 	}
 }
 
+// overlapping stroke triangles are only invisible for opaque colors,
+// and clip paths need stroke polygons to clip against.
+static bool canStrokeDirectly(const PathRef &path) {
+	const NSVGshape *shape = path->getNSVG();
+
+	if (shape->stroke.type != NSVG_PAINT_COLOR ||
+		(shape->stroke.color >> 24) != 0xff ||
+		shape->opacity < 1.0f) {
+		return false;
+	}
+
+#ifdef NSVG_CLIP_PATHS
+	if (!path->getClipIndices().empty()) {
+		return false;
+	}
+#endif
+
+	return true;
+}
+
 void AbstractAdaptiveFlattener::flatten(
 	const PathRef &path,
-	Tesselation &tesselation) const {
+	ClipperPaths &polylines) const {
+
+	const int n = path->getNumSubpaths();
+	polylines.reserve(polylines.size() + n);
+	for (int i = 0; i < n; i++) {
+		polylines.push_back(flatten(path->getSubpath(i)));
+	}
+}
+
+void AbstractAdaptiveFlattener::tesselate(
+	const PathRef &path,
+	ClipperPaths &polylines,
+	Tesselation &tesselation,
+	bool directStrokes) const {
 
 	const int n = path->getNumSubpaths();
 	bool closed = true;
 	for (int i = 0; i < n; i++) {
-		const auto subpath = path->getSubpath(i);
-		tesselation.fill.push_back(flatten(subpath));
-		closed = closed && subpath->isClosed();
+		closed = closed && path->getSubpath(i)->isClosed();
 	}
 
+	tesselation.fill = std::move(polylines);
+
 	NSVGshape * const shape = &path->nsvg;
 	const ClipperLib::PolyFillType fillType = path->getClipperFillType();
 
@@ -397,6 +436,25 @@ void AbstractAdaptiveFlattener::flatten(
 
 	ClipperLib::SimplifyPolygons(tesselation.fill, fillType);
 
+	if (hasStroke && directStrokes && canStrokeDirectly(path)) {
+		PolylineStroker::Style style;
+		style.halfWidth = shape->strokeWidth * 0.5f;
+		style.join = shape->strokeLineJoin;
+		style.cap = shape->strokeLineCap;
+		style.miterLimit = shape->miterLimit;
+		style.tolerance = clipper.arcTolerance / clipper.scale;
+
+		PolylineStroker stroker(style,
+			tesselation.strokeVertices, tesselation.strokeTriangles);
+		for (const ClipperPath &line : lines) {
+			stroker.stroke(line, clipper.scale,
+				closed && shape->strokeDashCount == 0);
+		}
+
+		// no need to cut the stroke out of the fill, as it is opaque.
+		return;
+	}
+
 	if (hasStroke) {
 		float lineOffset = shape->strokeWidth * clipper.scale * 0.5f;
 		if (lineOffset < 1.0f) {
@@ -408,10 +466,22 @@ void AbstractAdaptiveFlattener::flatten(
 
 		ClipperLib::ClipperOffset offset(
 			shape->miterLimit, clipper.arcTolerance);
-		offset.AddPaths(lines,
-			joinType(shape->strokeLineJoin),
-			endType(shape->strokeLineCap,
-				closed && shape->strokeDashCount == 0));
+		const ClipperLib::JoinType join = joinType(shape->strokeLineJoin);
+		const ClipperLib::EndType end = endType(shape->strokeLineCap,
+			closed && shape->strokeDashCount == 0);
+		for (const ClipperPath &line : lines) {
+			if (line.size() > 1) {
+				offset.AddPath(line, join, end);
+			} else if (line.size() == 1 &&
+				shape->strokeLineCap != NSVG_CAP_BUTT) {
+				// clipper offsets single points to circles for round
+				// joins and to squares otherwise, i.e. like our caps.
+				offset.AddPath(line,
+					shape->strokeLineCap == NSVG_CAP_ROUND ?
+						ClipperLib::jtRound : ClipperLib::jtSquare,
+					ClipperLib::etOpenRound);
+			}
+		}
 		offset.Execute(tesselation.stroke, lineOffset);
 
 		ClipperPaths stroke;
@@ -484,18 +554,40 @@ int RigidFlattener::size(const SubpathRef &subpath) const {
 int RigidFlattener::flatten(
 	const SubpathRef &subpath, const MeshRef &mesh, int index) const {
 
-	const NSVGpath *path = &subpath->nsvg;
-	const int npts = path->npts;
-
-	if (npts < 3) {
+	if (subpath->nsvg.npts < 3) {
 		return 0;
 	}
 
-	const int n = ncurves(npts);
+	const int numVertices = size(subpath);
+	flatten(subpath, mesh->vertices(index, numVertices));
+	return numVertices;
+}
+
+ClipperPath RigidFlattener::toClipperPath(
+	const SubpathRef &subpath, float scale) const {
+
+	ClipperPath result;
+	if (subpath->nsvg.npts < 3) {
+		return result;
+	}
+
+	std::vector<vec2> points(size(subpath));
+	flatten(subpath, Vertices(points.data(), sizeof(vec2)));
 
+	result.reserve(points.size());
+	for (const vec2 &p : points) {
+		result.push_back(ClipperPoint(
+			ClipperLib::cInt(p.x * scale), ClipperLib::cInt(p.y * scale)));
+	}
+	return result;
+}
+
+void RigidFlattener::flatten(
+	const SubpathRef &subpath, const Vertices &vertices) const {
+
+	const NSVGpath *path = &subpath->nsvg;
+	const int n = ncurves(path->npts);
 	const int verticesPerCurve = (1 << _depth);
-	const int numVertices = 1 + n * verticesPerCurve;
-	const auto vertices = mesh->vertices(index, numVertices);
 
 	vertices[0].x = path->pts[0];
 	vertices[0].y = path->pts[1];
@@ -512,8 +604,7 @@ int RigidFlattener::flatten(
 		assert(v - v0 == verticesPerCurve);
 	}
 
-	assert(v == numVertices);
-	return numVertices;
+	assert(v == 1 + n * verticesPerCurve);
 }
 
 END_TOVE_NAMESPACE
@@ -23,6 +23,10 @@ extern int toveMaxFlattenSubdivisions;
 struct Tesselation {
 	ClipperLib::Paths fill;
 	ClipperLib::PolyTree stroke;
+
+	// strokes triangulated by PolylineStroker, bypassing stroke.
+	std::vector<vec2> strokeVertices;
+	std::vector<ToveVertexIndex> strokeTriangles;
 };
 
 class AntiGrainFlattener {
@@ -57,12 +61,14 @@ class DefaultCurveFlattener {
 private:
 	const float resolution;
 	const int recursionLimit;
+	int pathRecursionLimit;
 	float tolerance;
 
 public:
 	inline DefaultCurveFlattener(const DefaultCurveFlattener& r) :
 		resolution(r.resolution),
 		recursionLimit(r.recursionLimit),
+		pathRecursionLimit(r.recursionLimit),
 		tolerance(0.0f) {
 	}
 
@@ -71,11 +77,19 @@ public:
 		int recursionLimit) :
 		resolution(resolution),
 		recursionLimit(std::min(toveMaxFlattenSubdivisions, recursionLimit)),
+		pathRecursionLimit(this->recursionLimit),
 		tolerance(0.0f) {
 	}
 
+	inline float getResolution() const {
+		return resolution;
+	}
+
 	ClipperParameters configure(float extent);
 
+	// a path that covers only a few pixels never needs deep subdivision.
+	void configurePath(float pixelSize);
+
 	void flatten(
 		float x1, float y1, float x2, float y2,
 		float x3, float y3, float x4, float y4,
@@ -96,17 +110,54 @@ private:
 
 protected:
 	ClipperParameters clipper;
+	float unitsPerPixel;
 
 public:
+	inline AbstractAdaptiveFlattener() : unitsPerPixel(1.0f) {
+	}
+
 	virtual void configure(float extent) = 0;
 
+	// configure for drawing at the given scale (pixels per unit).
+	virtual void configureView(float pixelsPerUnit) = 0;
+
+	// adjust subdivision to a path's size in pixels.
+	virtual void configurePath(float pixelSize) = 0;
+
+	inline float getUnitsPerPixel() const {
+		return unitsPerPixel;
+	}
+
 	inline float getClipperScale() const {
 		return clipper.scale;
 	}
 
+	// flattening tolerance in clipper units.
+	inline float getTolerance() const {
+		return clipper.arcTolerance;
+	}
+
+	// flattens the subpaths of path into one polyline each.
 	void flatten(
 		const PathRef &path,
-		Tesselation &tesselation) const;
+		ClipperPaths &polylines) const;
+
+	// computes fill and stroke geometry from flattened polylines. if
+	// directStrokes is set, opaque strokes are triangulated directly.
+	void tesselate(
+		const PathRef &path,
+		ClipperPaths &polylines,
+		Tesselation &tesselation,
+		bool directStrokes = false) const;
+
+	inline void flatten(
+		const PathRef &path,
+		Tesselation &tesselation) const {
+
+		ClipperPaths polylines;
+		flatten(path, polylines);
+		tesselate(path, polylines, tesselation);
+	}
 
 	virtual ~AbstractAdaptiveFlattener() {
 	}
@@ -163,6 +214,15 @@ protected:
 public:
 	virtual void configure(float extent) {
 		clipper = curveFlattener.configure(extent);
+		unitsPerPixel = clipper.arcTolerance / clipper.scale;
+	}
+
+	virtual void configureView(float pixelsPerUnit) {
+		configure(pixelsPerUnit / curveFlattener.getResolution());
+	}
+
+	virtual void configurePath(float pixelSize) {
+		curveFlattener.configurePath(pixelSize);
 	}
 
 	AdaptiveFlattener(const CurveFlattener &curveFlattener) :
@@ -181,10 +241,15 @@ private:
 		float x1, float y1, float x2, float y2,
 		float x3, float y3, float x4, float y4) const;
 
+	void flatten(const SubpathRef &subpath, const Vertices &vertices) const;
+
 public:
 	int size(const SubpathRef &subpath) const;
 	int flatten(const SubpathRef &subpath, const MeshRef &mesh, int index) const;
 
+	// flattens into a polygon for clipping, at the given clipper scale.
+	ClipperPath toClipperPath(const SubpathRef &subpath, float scale) const;
+
 	inline RigidFlattener(int subdivisions, float offset) :
 		_depth(std::min(toveMaxFlattenSubdivisions, subdivisions)),
 		_offset(offset) {
@@ -12,6 +12,12 @@
 #include "../common.h"
 #include "mesh.h"
 #include "../path.h"
+#include "vcache.h"
+#include "worker.h"
+#include <chrono>
+#include <sstream>
+#include <atomic>
+#include <tuple>
 #if TOVE_DEBUG
 #include <iostream>
 #endif
@@ -53,7 +59,16 @@ AbstractMesh::AbstractMesh(const NameRef &name, uint16_t stride) :
 	mVertexCount(0),
 	mOwnsBuffer(true),
 	mName(name),
-	mStride(stride) {
+	mStride(stride),
+	mOptimizeIndices(false),
+	mOptimizedValid(false),
+	mOptimizedMode(TRIANGLES_LIST),
+	mWeldedVertices(0),
+	mVertexBufferBytes(0),
+	mAccountedBytes(0),
+	mDirtyBegin(std::numeric_limits<int32_t>::max()),
+	mDirtyEnd(0),
+	mRigidEpoch(0) {
 }
 
 AbstractMesh::~AbstractMesh() {
@@ -64,10 +79,13 @@ AbstractMesh::~AbstractMesh() {
 	for (auto i : mSubmeshes) {
 		delete i.second;
 	}
+	memory::update(memory::MEMORY_MESHES, mAccountedBytes, 0);
 }
 
 ToveTrianglesMode AbstractMesh::getIndexMode() const {
-	if (mSubmeshes.size() == 1) {
+	if (useOptimizedIndices()) {
+		return mOptimizedMode;
+	} else if (mSubmeshes.size() == 1) {
 		return mSubmeshes.begin()->second->getIndexMode();
 	} else {
 		return TRIANGLES_LIST;
@@ -75,9 +93,14 @@ ToveTrianglesMode AbstractMesh::getIndexMode() const {
 }
 
 int32_t AbstractMesh::getIndexCount() const {
+	if (useOptimizedIndices()) {
+		return mCoalescedTriangles.size();
+	}
 	int32_t k = 0;
 	for (auto submesh : mSubmeshes) {
-		k += submesh.second->getIndexCount();
+		if (isSubmeshVisible(submesh.first)) {
+			k += submesh.second->getIndexCount();
+		}
 	}
 	return k;
 }
@@ -86,10 +109,19 @@ void AbstractMesh::copyIndexData(
 	ToveVertexIndex *indices,
 	int32_t indexCount) const {
 
+	if (useOptimizedIndices()) {
+		std::memcpy(indices, mCoalescedTriangles.data(),
+			std::min(indexCount, int32_t(mCoalescedTriangles.size())) *
+				sizeof(ToveVertexIndex));
+		return;
+	}
+
 	const int n = mSubmeshes.size();
 	if (n == 1) {
-		mSubmeshes.begin()->second->copyIndexData(
-			indices, indexCount);
+		if (isSubmeshVisible(mSubmeshes.begin()->first)) {
+			mSubmeshes.begin()->second->copyIndexData(
+				indices, indexCount);
+		}
 	} else {
 		// subtle point: mSubmeshes needs to be ordered (e.g.
 		// a map here) otherwise our triangle order would be
@@ -97,6 +129,9 @@ void AbstractMesh::copyIndexData(
 
 		int32_t offset = 0;
 		for (auto submesh : mSubmeshes) {
+			if (!isSubmeshVisible(submesh.first)) {
+				continue;
+			}
 			Submesh *m = submesh.second;
 			m->copyIndexData(
 				indices + offset, indexCount - offset);
@@ -105,6 +140,69 @@ void AbstractMesh::copyIndexData(
 	}
 }
 
+void AbstractMesh::setOptimizeIndices(bool optimize) {
+	mOptimizeIndices = optimize;
+	mOptimizedValid = false;
+	mCoalescedTriangles.clear();
+	if (!optimize) {
+		mCoalescedTriangles.shrink_to_fit();
+		accountMemory();
+	}
+}
+
+bool AbstractMesh::useOptimizedIndices() const {
+	if (!mOptimizeIndices) {
+		return false;
+	}
+	if (mOptimizedValid) {
+		return true;
+	}
+
+	for (auto submesh : mSubmeshes) {
+		if ((submesh.first >> 24) != 0 ||
+			submesh.second->getIndexMode() != TRIANGLES_LIST) {
+			// levels of detail and line strips rely on the layout
+			// of the unoptimized indices.
+			return false;
+		}
+	}
+
+	// triangles only get reordered inside each submesh, so that
+	// paths still get drawn in their original order.
+	std::vector<ToveVertexIndex> list;
+	std::vector<ToveVertexIndex> strip;
+	VertexCacheOptimizer optimizer;
+	Stripifier stripifier;
+
+	mCoalescedTriangles.clear();
+	for (auto submesh : mSubmeshes) {
+		if (!isSubmeshVisible(submesh.first)) {
+			continue;
+		}
+		const Submesh *m = submesh.second;
+		const int32_t n = m->getIndexCount();
+		list.resize(n);
+		m->copyIndexData(list.data(), n);
+		optimizer.optimize(list.data(), n);
+		stripifier.stripify(list.data(), n, strip);
+		mCoalescedTriangles.insert(
+			mCoalescedTriangles.end(), list.begin(), list.end());
+	}
+
+	// only use a strip if it pays off, i.e. needs fewer indices even
+	// with the degenerate triangles that join separate strips.
+	if (strip.size() < mCoalescedTriangles.size()) {
+		mCoalescedTriangles.swap(strip);
+		mOptimizedMode = TRIANGLES_STRIP;
+	} else {
+		mOptimizedMode = TRIANGLES_LIST;
+	}
+	accountMemory();
+
+	mOptimizedValid = true;
+	return true;
+}
+
 void AbstractMesh::setNewExternalVertexBuffer(
 	void *buffer,
 	size_t bufferByteSize) {
@@ -119,11 +217,97 @@ void AbstractMesh::setNewExternalVertexBuffer(
 	if (mOwnsBuffer && mVertices) {
 		free(mVertices);
 		mVertices = nullptr;
+		mVertexBufferBytes = 0;
+		accountMemory();
 	}
 
 	mVertices = buffer;
 	mVertexCount = bufferByteSize / mStride;
 	mOwnsBuffer = false;
+
+	// a new buffer needs a full upload.
+	mDirtyBegin = 0;
+	mDirtyEnd = mVertexCount;
+}
+
+ToveVertexRange AbstractMesh::fetchDirtyRange() {
+	const int32_t begin = std::max(mDirtyBegin, 0);
+	const int32_t end = std::min(mDirtyEnd, mVertexCount);
+
+	mDirtyBegin = std::numeric_limits<int32_t>::max();
+	mDirtyEnd = 0;
+
+	if (begin >= end) {
+		return ToveVertexRange{0, 0};
+	}
+	return ToveVertexRange{begin, end - begin};
+}
+
+ToveVertexQuantization AbstractMesh::computeQuantization() const {
+	if (mVertexCount < 1) {
+		return ToveVertexQuantization{0.0f, 0.0f, 1.0f};
+	}
+
+	const Vertices v = peekVertices(0);
+	float x0 = v[0].x, y0 = v[0].y;
+	float x1 = x0, y1 = y0;
+	for (int i = 1; i < mVertexCount; i++) {
+		const vec2 &p = v[i];
+		x0 = std::min(x0, p.x);
+		y0 = std::min(y0, p.y);
+		x1 = std::max(x1, p.x);
+		y1 = std::max(y1, p.y);
+	}
+
+	// use one scale for both axes, so that drawing needs no shear.
+	const float extent = std::max(x1 - x0, y1 - y0);
+	return ToveVertexQuantization{
+		x0, y0, extent > 0.0f ? 1.0f / extent : 1.0f};
+}
+
+bool AbstractMesh::copyVertexData(
+	ToveVertexFormat format,
+	const ToveVertexQuantization &quantization,
+	void *buffer,
+	size_t bufferByteSize) const {
+
+	const int outStride = getVertexByteSize(format);
+	if (bufferByteSize < size_t(mVertexCount) * outStride) {
+		tove::report::err("vertex buffer too small.");
+		return false;
+	}
+
+	if (format == TOVE_VERTEX_FLOAT32) {
+		std::memcpy(buffer, mVertices, mVertexCount * mStride);
+		return true;
+	}
+
+	const Vertices v = peekVertices(0);
+	const int attrSize = mStride - sizeof(vec2);
+	const float x0 = quantization.x0;
+	const float y0 = quantization.y0;
+	const float scale = quantization.scale;
+
+	uint8_t *out = static_cast<uint8_t*>(buffer);
+	for (int i = 0; i < mVertexCount; i++) {
+		const Vertices p = v + i;
+		const float x = (p->x - x0) * scale;
+		const float y = (p->y - y0) * scale;
+
+		uint16_t *position = reinterpret_cast<uint16_t*>(out);
+		if (format == TOVE_VERTEX_UNORM16) {
+			position[0] = uint16_t(clamp(x, 0.0f, 1.0f) * 65535.0f + 0.5f);
+			position[1] = uint16_t(clamp(y, 0.0f, 1.0f) * 65535.0f + 0.5f);
+		} else {
+			store_gpu_float(position[0], x);
+			store_gpu_float(position[1], y);
+		}
+
+		std::memcpy(out + 4, p.attr(), attrSize);
+		out += outStride;
+	}
+
+	return true;
 }
 
 void AbstractMesh::reserve(int32_t n) {
@@ -141,13 +325,15 @@ void AbstractMesh::reserve(int32_t n) {
 
 		mVertexCount = n;
 
+		mVertexBufferBytes = nextpow2(mVertexCount) * mStride;
 	    mVertices = realloc(
 	    	mVertices,
-			nextpow2(mVertexCount) * mStride);
+			mVertexBufferBytes);
 
 		if (!mVertices) {
 			TOVE_FATAL("out of memory during vertex allocation");
 		}
+		accountMemory();
 
 		if (previousBuffer) {
 			std::memcpy(
@@ -170,6 +356,7 @@ void AbstractMesh::setCacheSize(int size) {
 
 void AbstractMesh::clear(bool ensureOwnBuffer) {
 	mVertexCount = 0;
+	mRigidEpoch = 0;
 	if (ensureOwnBuffer && !mOwnsBuffer) {
 		mVertices = nullptr;
 		mOwnsBuffer = true;
@@ -178,9 +365,71 @@ void AbstractMesh::clear(bool ensureOwnBuffer) {
 		delete submesh.second;
 	}
 	mSubmeshes.clear();
+	mVisibility.clear();
+	mOptimizedValid = false;
+	mWeldedVertices = 0;
+}
+
+bool AbstractMesh::setPathVisible(int pathIndex, bool visible) {
+	if (pathIndex >= int(mVisibility.size())) {
+		if (visible) {
+			return false;
+		}
+		mVisibility.resize(pathIndex + 1, PathVisibility{true, 0});
+	}
+	PathVisibility &v = mVisibility[pathIndex];
+	if (v.visible == visible) {
+		return false;
+	}
+	v.visible = visible;
+	mOptimizedValid = false;
+	return true;
+}
+
+void AbstractMesh::addMissedUpdates(
+	int pathIndex, ToveMeshUpdateFlags update) {
+
+	if (pathIndex >= int(mVisibility.size())) {
+		mVisibility.resize(pathIndex + 1, PathVisibility{true, 0});
+	}
+	mVisibility[pathIndex].missed |= update;
+}
+
+ToveMeshUpdateFlags AbstractMesh::takeMissedUpdates(int pathIndex) {
+	if (pathIndex >= int(mVisibility.size())) {
+		return 0;
+	}
+	const ToveMeshUpdateFlags missed = mVisibility[pathIndex].missed;
+	mVisibility[pathIndex].missed = 0;
+	return missed;
+}
+
+bool AbstractMesh::moveToRigidFrame(
+	uint32_t epoch, const nsvg::Transform &transform) {
+
+	if (epoch == 0 || epoch != mRigidEpoch) {
+		return false;
+	}
+
+	const nsvg::Transform delta = getRigidDelta(transform);
+	mRigidTransform = transform;
+
+	const int32_t n = mVertexCount;
+	if (delta.isIdentity() || n < 1) {
+		return true;
+	}
+
+	Vertices v = vertices(0, n);
+	for (int32_t i = 0; i < n; i++) {
+		vec2 &p = v[i];
+		delta.transformPoint(p.x, p.y);
+	}
+
+	return true;
 }
 
 void AbstractMesh::clearTriangles() {
+	mOptimizedValid = false;
 	for (auto submesh : mSubmeshes) {
 		submesh.second->clearTriangles();
 	}
@@ -228,27 +477,38 @@ void Submesh::addClipperPaths(
 		mapbox::earcut<ToveVertexIndex>(polygon);
 	mTriangles.add(indices, i0);
 #else
+	// after clipping, holes and stroke outlines often share points. we
+	// weld identical points into one vertex; the triangulation itself
+	// only looks at positions, so it does not change.
+	int numPoints = 0;
+	for (const ClipperPath &path : paths) {
+		numPoints += path.size();
+	}
+
+	const int index0 = mMesh->getVertexCount();
+	IntVertexMap vertexMap;
+	vertexMap.reserve(numPoints);
+	std::vector<const ClipperPoint*> unique;
+	unique.reserve(numPoints);
+
 	std::list<TPPLPoly> polys;
 	for (const ClipperPath &path : paths) {
 		const int n = path.size();
 		TPPLPoly poly;
 		poly.Init(n);
-		int index = mMesh->getVertexCount();
- 	   	auto v = vertices(index, n);
 
 		for (int j = 0; j < n; j++) {
 			const ClipperPoint &p = path[j];
 
-			const float x = p.X / scale;
-			const float y = p.Y / scale;
-
-			v->x = x;
-			v->y = y;
-			v++;
+			const auto r = vertexMap.insert(std::make_pair(
+				p, ToveVertexIndex(index0 + unique.size())));
+			if (r.second) {
+				unique.push_back(&p);
+			}
 
-			poly[j].x = x;
-			poly[j].y = y;
-			poly[j].id = index++;
+			poly[j].x = p.X / scale;
+			poly[j].y = p.Y / scale;
+			poly[j].id = r.first->second;
 		}
 
 		if (poly.GetOrientation() == TPPL_CW) {
@@ -258,6 +518,17 @@ void Submesh::addClipperPaths(
 		polys.push_back(poly);
 	}
 
+	const int numVertices = unique.size();
+	if (numVertices > 0) {
+		auto v = vertices(index0, numVertices);
+		for (const ClipperPoint *p : unique) {
+			v->x = p->X / scale;
+			v->y = p->Y / scale;
+			v++;
+		}
+	}
+	mMesh->addWeldedVertices(numPoints - numVertices);
+
 	TPPLPartition partition;
 	std::list<TPPLPoly> triangles;
 	//if (partition.Triangulate_MONO(&polys, &triangles) == 0) {
@@ -271,6 +542,24 @@ void Submesh::addClipperPaths(
 #endif
 }
 
+void Submesh::addTriangles(
+	const std::vector<vec2> &points,
+	const std::vector<ToveVertexIndex> &triangles) {
+
+	const int n = points.size();
+	if (n < 1) {
+		return;
+	}
+
+	const int index = mMesh->getVertexCount();
+	auto v = vertices(index, n);
+	for (int i = 0; i < n; i++) {
+		v[i] = points[i];
+	}
+
+	mTriangles.add(triangles, index);
+}
+
 void Submesh::clearTriangles() {
 	mTriangles.clear();
 }
@@ -439,10 +728,114 @@ static ClipperLib::Path toClipperPath(SubpathCleaner &c, IntVertexMap &m, float
 }
 
 
+// the expensive part of a fill triangulation. does not touch the mesh
+// and does not report, so that it can run on a worker thread.
+static Submesh::FillTriangulation triangulateFill(
+	ClipperLib::Paths clipperPaths,
+	IntVertexMap vertexMap,
+	const float clipperScale,
+	const ClipperLib::PolyFillType fillType,
+	VanishingTriangles vanishing) {
+
+	ClipperLib::SimplifyPolygons(clipperPaths, fillType);
+
+	std::list<TPPLPoly> polys;
+
+	for (const auto &path : clipperPaths) {
+		polys.push_back(TPPLPoly());
+		TPPLPoly &poly = polys.back();
+
+		const int n = path.size();
+		poly.Init(n);
+		for (int i = 0; i < n; i++) {
+			const auto &p = path[i];
+			poly[i].x = p.X / clipperScale;
+			poly[i].y = p.Y / clipperScale;
+			const auto it = vertexMap.find(p);
+			if (it != vertexMap.end()) {
+				poly[i].id = it->second;
+			} else {
+				poly[i].id = -1;
+			}
+		}
+
+		if (poly.GetOrientation() == TPPL_CW) {
+			poly.SetHole(true);
+		}
+	}
+
+	TPPLPartition partition;
+
+	std::list<TPPLPoly> convex;
+	if (partition.ConvexPartition_HM(&polys, &convex) == 0) {
+		return Submesh::FillTriangulation{
+			nullptr, "triangulation (ConvexPartition_HM) failed."};
+	}
+
+	const char *error = nullptr;
+	Triangulation *triangulation =
+		TriangulationPool::shared().acquire(TRIANGLES_LIST);
+	triangulation->partition.assign(convex);
+	triangulation->vanishing = std::move(vanishing);
+	for (auto i = convex.begin(); i != convex.end(); i++) {
+		std::list<TPPLPoly> triangles;
+		TPPLPoly &p = *i;
+
+		//if (partition.Triangulate_MONO(&p, &triangles) == 0) {
+			if (partition.Triangulate_EC(&p, &triangles) == 0) {
+				error = "triangulation failed.";
+				continue;
+			}
+		//}
+
+		triangulation->triangles.add(triangles);
+	}
+
+	return Submesh::FillTriangulation{triangulation, error};
+}
+
+// a fill triangulation handed to the worker thread. whoever of the
+// worker and the Submesh comes last releases the result.
+struct Submesh::PendingFill {
+	enum State {
+		QUEUED,
+		DONE,
+		CANCELLED
+	};
+
+	std::atomic<int> state;
+	FillTriangulation result;
+
+	inline PendingFill() : state(QUEUED), result{nullptr, nullptr} {
+	}
+
+	// true if we got it, otherwise the other side still owns result.
+	inline bool finish(State to) {
+		int expected = QUEUED;
+		return state.compare_exchange_strong(expected, to);
+	}
+};
+
+Submesh::~Submesh() {
+	if (mPending && !mPending->finish(PendingFill::CANCELLED)) {
+		// the worker is done, but nobody swapped in its result.
+		if (mPending->result.triangulation) {
+			TriangulationPool::shared().release(
+				mPending->result.triangulation);
+		}
+	}
+}
+
 void Submesh::triangulateFixedResolutionFill(
 	const int vertexIndex0,
 	const PathRef &path,
-	const RigidFlattener &flattener) {
+	const RigidFlattener &flattener,
+	bool async) {
+
+	if (async && mPending) {
+		// still busy with an earlier triangulation.
+		return;
+	}
 
 	const int numSubpaths = path->getNumSubpaths();
 
@@ -521,60 +914,184 @@ void Submesh::triangulateFixedResolutionFill(
 			mCleaner, vertexMap, clipperScale));
 	}
 
-	ClipperLib::SimplifyPolygons(
-		clipperPaths, path->getClipperFillType());
+	if (async) {
+		const std::shared_ptr<PendingFill> pending =
+			std::make_shared<PendingFill>();
+		mPending = pending;
+
+		// std::function needs copyable jobs, so the inputs get shared.
+		const auto input = std::make_shared<std::tuple<
+			ClipperLib::Paths, IntVertexMap, VanishingTriangles>>(
+				std::move(clipperPaths),
+				std::move(vertexMap),
+				VanishingTriangles(mCleaner.fetchVanishing()));
+		const ClipperLib::PolyFillType fillType = path->getClipperFillType();
+
+		Worker::shared().submit([pending, input, clipperScale, fillType] () {
+			if (pending->state.load() == PendingFill::CANCELLED) {
+				return;
+			}
+			FillTriangulation t{nullptr, "triangulation failed."};
+			try {
+				t = triangulateFill(
+					std::move(std::get<0>(*input)),
+					std::move(std::get<1>(*input)),
+					clipperScale,
+					fillType,
+					std::move(std::get<2>(*input)));
+			} catch (...) {
+				// reported through t.error on the main thread.
+			}
+			pending->result = t;
+			if (!pending->finish(PendingFill::DONE) && t.triangulation) {
+				// the Submesh is gone.
+				TriangulationPool::shared().release(t.triangulation);
+			}
+		});
+	} else {
+		addFillTriangulation(triangulateFill(
+			std::move(clipperPaths),
+			std::move(vertexMap),
+			clipperScale,
+			path->getClipperFillType(),
+			VanishingTriangles(mCleaner.fetchVanishing())));
+	}
+#endif
+}
 
-	std::list<TPPLPoly> polys;
+void Submesh::addFillTriangulation(const FillTriangulation &t) {
+	if (t.error) {
+		tove::report::warn(t.error);
+	}
+	if (t.triangulation) {
+		mTriangles.addAndMakeCurrent(t.triangulation);
+	}
+}
 
-	for (const auto &path : clipperPaths) {
-		polys.push_back(TPPLPoly());
-		TPPLPoly &poly = polys.back();
+bool Submesh::swapPendingTriangulation() {
+	if (!mPending ||
+		mPending->state.load() != PendingFill::DONE) {
+		return false;
+	}
+	FillTriangulation t = mPending->result;
+	mPending.reset();
+
+	if (t.triangulation && !t.triangulation->check(mMesh->peekVertices(0))) {
+		// the points changed while the worker was busy, so that the
+		// result would give broken triangles.
+		TriangulationPool::shared().release(t.triangulation);
+		t.triangulation = nullptr;
+	}
+	addFillTriangulation(t);
+	return t.triangulation != nullptr;
+}
 
-		const int n = path.size();
-		poly.Init(n);
-		for (int i = 0; i < n; i++) {
-			const auto &p = path[i];
-			poly[i].x = p.X / clipperScale;
-			poly[i].y = p.Y / clipperScale;
-			const auto it = vertexMap.find(p);
-			if (it != vertexMap.end()) {
-				poly[i].id = it->second;
-			} else {
-				poly[i].id = -1;
-			}
+uint64_t AbstractMesh::computeFingerprint() const {
+	// FNV-1a
+	uint64_t h = 0xcbf29ce484222325ULL;
+	const auto mix = [&h] (uint32_t x) {
+		for (int i = 0; i < 4; i++) {
+			h ^= (x >> (i * 8)) & 0xff;
+			h *= 0x100000001b3ULL;
 		}
+	};
 
-		if (poly.GetOrientation() == TPPL_CW) {
-			poly.SetHole(true);
-		}
+	mix(mVertexCount);
+	mix(mStride);
+	for (auto submesh : mSubmeshes) {
+		mix(submesh.first);
+		mix(submesh.second->getIndexMode());
 	}
+	return h;
+}
 
-	TPPLPartition partition;
+const char *AbstractMesh::serializeTriangulations() {
+	std::ostringstream out;
+	out << "tove-triangle-cache 1\n";
+	out << computeFingerprint() << " " << mSubmeshes.size() << "\n";
+	for (auto submesh : mSubmeshes) {
+		out << submesh.first << "\n";
+		submesh.second->serializeTriangles(out);
+	}
+	mSerialized = out.str();
+	return mSerialized.c_str();
+}
 
-	std::list<TPPLPoly> convex;
-	if (partition.ConvexPartition_HM(&polys, &convex) == 0) {
-		tove::report::warn("triangulation (ConvexPartition_HM) failed.");
-		return;
+bool AbstractMesh::deserializeTriangulations(const char *s) {
+	std::istringstream in(s);
+
+	std::string magic;
+	int version;
+	in >> magic >> version;
+	if (!in || magic != "tove-triangle-cache" || version != 1) {
+		return false;
 	}
 
-	std::unique_ptr<Triangulation> triangulation(new Triangulation(
-		convex, mCleaner.fetchVanishing()));
-	for (auto i = convex.begin(); i != convex.end(); i++) {
-		std::list<TPPLPoly> triangles;
-		TPPLPoly &p = *i;
+	uint64_t fingerprint;
+	int numSubmeshes;
+	in >> fingerprint >> numSubmeshes;
+	if (!in || fingerprint != computeFingerprint() ||
+		numSubmeshes != int(mSubmeshes.size())) {
+		tove::report::warn("triangulations do not fit mesh.");
+		return false;
+	}
 
-		//if (partition.Triangulate_MONO(&p, &triangles) == 0) {
-			if (partition.Triangulate_EC(&p, &triangles) == 0) {
-				triangulationFailed(polys);
-				continue;
-			}
-		//}
+	// read everything first, so that broken input leaves us as we are.
+	std::vector<std::pair<Submesh*, DeserializedTriangulations>> loaded;
+	loaded.reserve(numSubmeshes);
+	for (int i = 0; i < numSubmeshes; i++) {
+		SubmeshId id;
+		in >> id;
+		const auto submesh = mSubmeshes.find(id);
+		if (!in || submesh == mSubmeshes.end()) {
+			return false;
+		}
+		loaded.emplace_back(submesh->second, DeserializedTriangulations());
+		if (!submesh->second->deserializeTriangles(in, loaded.back().second)) {
+			return false;
+		}
+	}
 
-		triangulation->triangles.add(triangles);
+	for (auto &submesh : loaded) {
+		submesh.first->assignTriangles(submesh.second);
 	}
 
-	mTriangles.addAndMakeCurrent(triangulation.release());
-#endif
+	// switch to triangulations that fit the current vertices.
+	for (auto submesh : mSubmeshes) {
+		bool changed;
+		submesh.second->findCachedTriangulation(changed);
+	}
+
+	mOptimizedValid = false;
+	return true;
+}
+
+ToveMeshUpdateFlags AbstractMesh::swapPendingTriangulations() {
+	bool swapped = false;
+	for (auto submesh : mSubmeshes) {
+		swapped |= submesh.second->swapPendingTriangulation();
+	}
+	if (swapped) {
+		invalidateIndices();
+		return UPDATE_MESH_TRIANGLES;
+	}
+	return 0;
+}
+
+ToveMemoryStats AbstractMesh::getMemoryUsage() const {
+	ToveMemoryStats stats;
+	stats.meshes = mAccountedBytes;
+	stats.triangles = mTriangleBudget.stats.bytes;
+	stats.cleaners = 0;
+	for (auto submesh : mSubmeshes) {
+		stats.cleaners += submesh.second->getCleanerByteSize();
+	}
+	stats.geometry = 0;
+	stats.gradients = 0;
+	stats.parser = 0;
+	stats.total = stats.meshes + stats.triangles + stats.cleaners;
+	stats.budget = 0;
+	return stats;
 }
 
 void AbstractMesh::setLineColor(
@@ -591,8 +1108,8 @@ void AbstractMesh::setFillColor(
 	const int vertexCount) {
 }
 
-Submesh *AbstractMesh::submesh(int pathIndex, int line) {
-	const SubmeshId id = pathIndex * 2 + line;
+Submesh *AbstractMesh::submesh(int pathIndex, int line, int lod) {
+	const SubmeshId id = (SubmeshId(lod) << 24) | (pathIndex * 2 + line);
 	const auto i = mSubmeshes.find(id);
 	if (i != mSubmeshes.end()) {
 		return i->second;
@@ -603,6 +1120,52 @@ Submesh *AbstractMesh::submesh(int pathIndex, int line) {
 	}
 }
 
+int AbstractMesh::getNumLODs() const {
+	if (mSubmeshes.empty()) {
+		return 1;
+	}
+	return (mSubmeshes.rbegin()->first >> 24) + 1;
+}
+
+ToveIndexRange AbstractMesh::getLODIndexRange(int lod) const {
+	ToveIndexRange range{0, 0};
+	for (auto submesh : mSubmeshes) {
+		if (!isSubmeshVisible(submesh.first)) {
+			continue;
+		}
+		const int level = submesh.first >> 24;
+		if (level < lod) {
+			range.first += submesh.second->getIndexCount();
+		} else if (level == lod) {
+			range.count += submesh.second->getIndexCount();
+		} else {
+			break;
+		}
+	}
+	return range;
+}
+
+ToveIndexRange AbstractMesh::getPathIndexRange(int pathIndex) const {
+	ToveIndexRange range{0, 0};
+	for (auto submesh : mSubmeshes) {
+		const SubmeshId id = submesh.first;
+		if ((id >> 24) > 0) {
+			break;
+		}
+		if (!isSubmeshVisible(id)) {
+			continue;
+		}
+		const int path = (id & 0xffffff) >> 1;
+		if (path < pathIndex) {
+			range.first += submesh.second->getIndexCount();
+		} else if (path == pathIndex) {
+			range.count += submesh.second->getIndexCount();
+		} else {
+			break;
+		}
+	}
+	return range;
+}
 
 Mesh::Mesh(const NameRef &name) : AbstractMesh(name, sizeof(float) * 2) {
 }
@@ -18,6 +18,7 @@
 #include "area.h"
 #include "../paint.h"
 #include "../subpath.h"
+#include "../accounting.h"
 #include <map>
 #include "../../thirdparty/robin-map/include/tsl/robin_map.h"
 
@@ -63,7 +64,60 @@ protected:
 	std::map<SubmeshId, Submesh*> mSubmeshes;
 	mutable std::vector<ToveVertexIndex> mCoalescedTriangles;
 
-	void reserve(int32_t n);
+	// optional copy of all indices, reordered for the vertex cache and
+	// possibly converted into one strip (see setOptimizeIndices).
+	bool mOptimizeIndices;
+	mutable bool mOptimizedValid;
+	mutable ToveTrianglesMode mOptimizedMode;
+
+	// builds the optimized indices if needed; returns false if they
+	// cannot be used for the current mesh.
+	bool useOptimizedIndices() const;
+
+	// vertices saved by welding identical points (since last clear).
+	int32_t mWeldedVertices;
+
+	std::string mSerialized;
+
+	// memory used by the triangle caches of our submeshes.
+	TriangleBudget mTriangleBudget;
+
+	// bytes of our own vertex buffer, and those accounted for our own
+	// vertex buffer and optimized indices (see accounting.h).
+	size_t mVertexBufferBytes;
+	mutable size_t mAccountedBytes;
+
+	inline void accountMemory() const {
+		memory::update(memory::MEMORY_MESHES, mAccountedBytes,
+			mVertexBufferBytes +
+			mCoalescedTriangles.capacity() * sizeof(ToveVertexIndex));
+	}
+
+	// vertex range written since the last fetchDirtyRange().
+	int32_t mDirtyBegin;
+	int32_t mDirtyEnd;
+
+	inline void markDirty(int32_t from, int32_t n) {
+		mDirtyBegin = std::min(mDirtyBegin, from);
+		mDirtyEnd = std::max(mDirtyEnd, from + n);
+	}
+
+	// rigid frame (see Graphics::getRigidEpoch) our vertices are in.
+	uint32_t mRigidEpoch;
+	nsvg::Transform mRigidTransform;
+
+	// per path visibility under a view rectangle. hidden paths keep
+	// their vertex ranges, but contribute no triangles; updates they
+	// missed while hidden are done once they become visible again.
+	struct PathVisibility {
+		bool visible;
+		ToveMeshUpdateFlags missed;
+	};
+	std::vector<PathVisibility> mVisibility;
+
+	inline bool isSubmeshVisible(SubmeshId id) const {
+		return isPathVisible((id & 0xffffff) >> 1);
+	}
 
 	void setNewExternalVertexBuffer(
 		void *buffer, size_t bufferByteSize);
@@ -74,12 +128,67 @@ public:
 
 	ToveTrianglesMode getIndexMode() const;
 
+	inline bool isPathVisible(int pathIndex) const {
+		return pathIndex >= int(mVisibility.size()) ||
+			mVisibility[pathIndex].visible;
+	}
+
+	// returns true if the path's visibility changed.
+	bool setPathVisible(int pathIndex, bool visible);
+
+	void addMissedUpdates(int pathIndex, ToveMeshUpdateFlags update);
+	ToveMeshUpdateFlags takeMissedUpdates(int pathIndex);
+
 	int32_t getIndexCount() const;
 
+	// reorders indices once for the post-transform vertex cache and uses
+	// a triangle strip where that needs fewer indices. only meant for
+	// static meshes, as any change of triangles redoes the whole pass.
+	// meshes with more than one level of detail are not optimized.
+	void setOptimizeIndices(bool optimize);
+
+	inline void invalidateIndices() {
+		mOptimizedValid = false;
+	}
+
 	void copyIndexData(
 		ToveVertexIndex *indices,
 		int32_t indexCount) const;
 
+	inline TriangleBudget *getTriangleBudget() {
+		return &mTriangleBudget;
+	}
+
+	// limits the bytes our triangle caches use (0 for no limit). caches
+	// evict least recently used triangulations once this is exceeded.
+	inline void setTriangleCacheBudget(uint64_t bytes) {
+		mTriangleBudget.stats.budget = bytes;
+	}
+
+	inline ToveTriangleCacheStats getTriangleCacheStats() const {
+		return mTriangleBudget.stats;
+	}
+
+	// bytes used by this mesh, with the categories of tove's global
+	// memory statistics. geometry, gradients and parser are always 0.
+	ToveMemoryStats getMemoryUsage() const;
+
+	// identifies the layout of vertices and submeshes, so that saved
+	// triangulations only get loaded into meshes they fit.
+	uint64_t computeFingerprint() const;
+
+	// text serialization of all cached triangulations (e.g. those of key
+	// frames), so that they can be loaded instead of computed again.
+	const char *serializeTriangulations();
+	bool deserializeTriangulations(const char *s);
+
+	// swaps in fill triangulations that finished on worker threads.
+	// returns UPDATE_MESH_TRIANGLES if any triangles changed.
+	ToveMeshUpdateFlags swapPendingTriangulations();
+
+	// grows the vertex count to at least n.
+	void reserve(int32_t n);
+
 	inline void clip(int n) {
 		mVertexCount = std::min(mVertexCount, n);
 	}
@@ -88,6 +197,12 @@ public:
 		if (from + n > mVertexCount) {
 			reserve(from + n);
 		}
+		markDirty(from, n);
+		return Vertices(mVertices, mStride, from);
+	}
+
+	// read only access, does not mark vertices as dirty.
+	inline Vertices peekVertices(int from) const {
 		return Vertices(mVertices, mStride, from);
 	}
 
@@ -96,6 +211,22 @@ public:
 	void clear(bool ensureOwnBuffer = false);
 	void clearTriangles();
 
+	inline void setRigidFrame(uint32_t epoch, const nsvg::Transform &transform) {
+		mRigidEpoch = epoch;
+		mRigidTransform = transform;
+	}
+
+	// the transform that takes our vertices into the given frame.
+	inline nsvg::Transform getRigidDelta(const nsvg::Transform &transform) const {
+		nsvg::Transform delta = mRigidTransform.inverse();
+		delta.multiply(transform);
+		return delta;
+	}
+
+	// transforms our vertices into the given frame without tesselating.
+	// only possible if the frame is from the same epoch as ours.
+	bool moveToRigidFrame(uint32_t epoch, const nsvg::Transform &transform);
+
 	virtual void setLineColor(
 		const PathRef &path,
 		const PathPaintInd &paint,
@@ -111,13 +242,51 @@ public:
 		return mVertexCount;
 	}
 
+	inline void addWeldedVertices(int32_t n) {
+		mWeldedVertices += n;
+	}
+
+	inline int32_t getNumWeldedVertices() const {
+		return mWeldedVertices;
+	}
+
 	inline void setExternalVertexBuffer(void *buffer, size_t bufferByteSize) {
 		if (buffer != mVertices) {
 			setNewExternalVertexBuffer(buffer, bufferByteSize);
 		}
 	}
 
-	Submesh *submesh(int pathIndex, int line);
+	ToveVertexRange fetchDirtyRange();
+
+	// true if paint is baked into the vertices, i.e. any change of
+	// paint implies a new tesselation.
+	virtual bool hasBakedColors() const {
+		return false;
+	}
+
+	// compact formats replace the 8 byte float position with 4 bytes
+	// and keep the remaining (color or paint) bytes of each vertex.
+	inline int getVertexByteSize(ToveVertexFormat format) const {
+		return format == TOVE_VERTEX_FLOAT32 ? mStride : mStride - 4;
+	}
+
+	ToveVertexQuantization computeQuantization() const;
+
+	bool copyVertexData(
+		ToveVertexFormat format,
+		const ToveVertexQuantization &quantization,
+		void *buffer,
+		size_t bufferByteSize) const;
+
+	// levels of detail live in separate submeshes that are ordered by
+	// level, so that each level is one contiguous range of indices.
+	Submesh *submesh(int pathIndex, int line, int lod = 0);
+
+	int getNumLODs() const;
+	ToveIndexRange getLODIndexRange(int lod) const;
+
+	// range of the indices of a path's visible fill and line at level 0.
+	ToveIndexRange getPathIndexRange(int pathIndex) const;
 
 	inline const NameRef &getName() const {
 		return mName;
@@ -125,17 +294,33 @@ public:
 };
 
 class Submesh {
+public:
+	// result of a fill triangulation, which might have been computed on
+	// a worker thread. errors get reported once back on the main thread.
+	struct FillTriangulation {
+		Triangulation *triangulation;
+		const char *error;
+	};
+
 private:
 	AbstractMesh * const mMesh;
 	TriangleCache mTriangles;
 	SubpathCleaner mCleaner;
 
+	// fill triangulation queued on the worker thread (see worker.h).
+	struct PendingFill;
+	std::shared_ptr<PendingFill> mPending;
+
+	void addFillTriangulation(const FillTriangulation &t);
+
 public:
 	inline Submesh(AbstractMesh *mesh) :
 		mMesh(mesh),
-		mTriangles(mesh->getName()) {
+		mTriangles(mesh->getName(), mesh->getTriangleBudget()) {
 	}
 
+	~Submesh();
+
 	inline ToveTrianglesMode getIndexMode() const {
 		return mTriangles.getIndexMode();
 	}
@@ -164,11 +349,19 @@ public:
 		const ClipperPaths &paths,
 		float scale);
 
-	// used by fixed flattener.
+	// adds vertices and triangles that index them from 0.
+	void addTriangles(
+		const std::vector<vec2> &points,
+		const std::vector<ToveVertexIndex> &triangles);
+
+	// used by fixed flattener. if async is set, the triangulation runs
+	// on a worker thread and the current triangles stay in use until
+	// swapPendingTriangulation() finds it finished.
 	void triangulateFixedResolutionFill(
 		const int vertexIndex0,
 		const PathRef &path,
-		const RigidFlattener &flattener);
+		const RigidFlattener &flattener,
+		bool async = false);
 	void triangulateFixedResolutionLine(
 		const int pathVertex,
 		const bool miter,
@@ -177,11 +370,36 @@ public:
 		const PathRef &path,
 		const RigidFlattener &flattener);
 
+	inline size_t getCleanerByteSize() const {
+		return mCleaner.getByteSize();
+	}
+
+	inline void serializeTriangles(std::ostream &out) const {
+		mTriangles.serialize(out);
+	}
+
+	inline bool deserializeTriangles(
+		std::istream &in, DeserializedTriangulations &loaded) const {
+		return TriangleCache::deserialize(
+			in, mMesh->getVertexCount(), loaded);
+	}
+
+	inline void assignTriangles(DeserializedTriangulations &loaded) {
+		mTriangles.assign(loaded);
+	}
+
+	// returns true if a finished background triangulation got swapped in.
+	bool swapPendingTriangulation();
+
+	inline bool hasPendingTriangulation() const {
+		return mPending != nullptr;
+	}
+
 	inline bool findCachedTriangulation(
 		bool &trianglesChanged) {
 		
 		return mTriangles.findCachedTriangulation(
-			vertices(0, mMesh->getVertexCount()),
+			mMesh->peekVertices(0),
 			trianglesChanged);
 	}
 
@@ -203,6 +421,10 @@ protected:
 public:
 	ColorMesh(const NameRef &name);
 
+	virtual bool hasBakedColors() const {
+		return true;
+	}
+
 	virtual void setLineColor(
 		const PathRef &path,
 		const PathPaintInd &paint,
@@ -11,12 +11,17 @@
 
 #include "../common.h"
 #include "meshifier.h"
+#include "decimate.h"
 #include "mesh.h"
 #include <sstream>
 #include <chrono>
+#include <cstring>
+#include <cmath>
 
 BEGIN_TOVE_NAMESPACE
 
+uint64_t AbstractTesselator::nextId = 0;
+
 void AbstractTesselator::beginTesselate(
 	Graphics *graphics,
 	float scale) {
@@ -26,17 +31,68 @@ void AbstractTesselator::beginTesselate(
 
 void AbstractTesselator::endTesselate() {
 	this->graphics = nullptr;
+	backToFront = false;
+}
+
+void AbstractTesselator::clipToMesh(
+	Graphics *graphics,
+	int clipIndex,
+	const MeshRef &mesh) {
+
+	mesh->clear(true);
+
+#ifdef NSVG_CLIP_PATHS
+	const ClipSetRef &clipSet = graphics->getClipSet();
+	if (!clipSet || clipIndex < 0 ||
+		clipIndex >= int(clipSet->getClips().size())) {
+		return;
+	}
+
+	const float *bounds = graphics->getBounds();
+	const float extent = std::max(
+		bounds[2] - bounds[0], bounds[3] - bounds[1]);
+
+	beginTesselate(graphics, 1.0f / extent);
+	const ClipRef &clip = clipSet->get(clipIndex);
+	clip->compute(*this);
+	endTesselate();
+
+	mesh->submesh(0, 0)->addClipperPaths(
+		clip->computed, getClipPathScale());
+#endif
 }
 
 ToveMeshUpdateFlags AbstractTesselator::graphicsToMesh(
 	Graphics *graphics,
 	ToveMeshUpdateFlags update, // UPDATE_MESH_EVERYTHING
 	const MeshRef &fill,
-	const MeshRef &line) {
+	const MeshRef &line,
+	const ToveBounds *view) {
+
+	const uint32_t epoch = graphics->getRigidEpoch();
+	const nsvg::Transform &rigid = graphics->getRigidTransform();
+
+	// points only moved through rigid transforms? then move vertices.
+	if (!view && (update & UPDATE_MESH_VERTICES) &&
+		(update & (UPDATE_MESH_COLORS | UPDATE_MESH_TRIANGLES |
+			UPDATE_MESH_GEOMETRY)) == 0 &&
+		allowsRigidShortcut(fill->getRigidDelta(rigid)) &&
+		(&fill == &line || allowsRigidShortcut(line->getRigidDelta(rigid))) &&
+		fill->moveToRigidFrame(epoch, rigid) &&
+		(&fill == &line || line->moveToRigidFrame(epoch, rigid))) {
+		return UPDATE_MESH_VERTICES;
+	}
 
 	const int n = graphics->getNumPaths();
 
-	if (!hasFixedSize()) {
+	// a view update only changes which paths are visible. adaptive
+	// meshes then append paths that come into view for the first time.
+	const bool viewOnly = (update & UPDATE_MESH_EVERYTHING) == 0 &&
+		(update & UPDATE_MESH_VIEW) != 0;
+	update &= ~UPDATE_MESH_VIEW;
+	const bool rebuild = !hasFixedSize() && !viewOnly;
+
+	if (rebuild) {
 		fill->clear(true);
 		line->clear(true);
 	}
@@ -47,20 +103,60 @@ ToveMeshUpdateFlags AbstractTesselator::graphicsToMesh(
 	const float extent = std::max(
 		bounds[2] - bounds[0], bounds[3] - bounds[1]);
 
+	// tesselating from top to bottom lets fills be clipped against the
+	// opaque fills above them. submeshes are ordered by path index, so
+	// this does not change the drawing order.
+	backToFront = rebuild && cullsOcclusion(fill);
+
 	beginTesselate(graphics, 1.0f / extent);
 
 	ToveMeshUpdateFlags updated = 0;
 	int fillIndex = 0;
 	int lineIndex = 0;
 
-	for (int i = 0; i < n; i++) {
-		updated |= pathToMesh(
-			update,
-			graphics->getPath(i),
-			i,
-			paintIndices->get(i),
-			fill, line,
-			fillIndex, lineIndex);
+	if (!hasFixedSize() && !rebuild) {
+		fillIndex = fill->getVertexCount();
+		lineIndex = line->getVertexCount();
+	}
+
+	for (int k = 0; k < n; k++) {
+		const int i = backToFront ? n - 1 - k : k;
+		const PathRef &path = graphics->getPath(i);
+		const bool visible = !view || path->intersects(*view);
+
+		ToveMeshUpdateFlags pathUpdate = update;
+		if (visible) {
+			pathUpdate |= fill->takeMissedUpdates(i);
+		} else {
+			// adaptive meshes do not contain hidden paths at all, whereas
+			// rigid meshes keep their vertex ranges but skip writing them.
+			fill->addMissedUpdates(i, hasFixedSize() ?
+				pathUpdate : (rebuild ? UPDATE_MESH_EVERYTHING : 0));
+			pathUpdate = 0;
+		}
+
+		if (hasFixedSize() || (visible && (rebuild || pathUpdate != 0))) {
+			updated |= pathToMesh(
+				pathUpdate,
+				path,
+				i,
+				paintIndices->get(i),
+				fill, line,
+				fillIndex, lineIndex);
+		}
+
+		const bool fillChanged = fill->setPathVisible(i, visible);
+		const bool lineChanged = &fill != &line &&
+			line->setPathVisible(i, visible);
+		if (fillChanged || lineChanged) {
+			updated |= UPDATE_MESH_TRIANGLES;
+		}
+	}
+
+	if (hasFixedSize()) {
+		// hidden paths at the end still own their vertex ranges.
+		fill->reserve(fillIndex);
+		line->reserve(lineIndex);
 	}
 
 	if (&fill != &line) {
@@ -68,6 +164,16 @@ ToveMeshUpdateFlags AbstractTesselator::graphicsToMesh(
 	}
 	line->clip(lineIndex);
 
+	if (rebuild || (update & UPDATE_MESH_VERTICES)) {
+		fill->setRigidFrame(epoch, rigid);
+		line->setRigidFrame(epoch, rigid);
+	}
+
+	if (updated & (UPDATE_MESH_TRIANGLES | UPDATE_MESH_GEOMETRY)) {
+		fill->invalidateIndices();
+		line->invalidateIndices();
+	}
+
 	endTesselate();
 
 	return updated;
@@ -83,28 +189,72 @@ static void clip(
 	const std::vector<TOVEclipPathIndex> &clipIndices =
 		path->getClipIndices();
 
-	if (!clipIndices.empty()) {
-		for (TOVEclipPathIndex i : clipIndices) {
-			ClipperLib::Clipper c;
-			c.AddPaths(
-				subject,
-				ClipperLib::ptSubject,
-				true);
-			c.AddPaths(
-				graphics->getClipAtIndex(i)->computed,
-				ClipperLib::ptClip,
-				true);
-			c.Execute(
-				ClipperLib::ctIntersection,
-				subject);
+	for (TOVEclipPathIndex i : clipIndices) {
+		if (subject.empty()) {
+			break;
+		}
+
+		const ClipRef &region = graphics->getClipAtIndex(i);
+
+		switch (region->classify(subject)) {
+			case Clip::OUTSIDE: {
+				subject.clear();
+			} break;
+
+			case Clip::INSIDE: {
+				// nothing to clip.
+			} break;
+
+			case Clip::PARTIAL: {
+				ClipperLib::Clipper c;
+				c.AddPaths(
+					subject,
+					ClipperLib::ptSubject,
+					true);
+				c.AddPaths(
+					region->computed,
+					ClipperLib::ptClip,
+					true);
+				c.Execute(
+					ClipperLib::ctIntersection,
+					subject);
+			} break;
 		}
 	}
 #endif
 }
 
 AdaptiveTesselator::AdaptiveTesselator(
-	AbstractAdaptiveFlattener *flattener) :
-	flattener(flattener) {
+	AbstractAdaptiveFlattener *flattener,
+	int levels) :
+	flattener(flattener),
+	levels(std::max(1, levels)),
+	viewScale(0.0f),
+	minPathSize(0.0f),
+	occlusionCulling(false) {
+}
+
+void AdaptiveTesselator::setViewScale(float scale, float minPathSize) {
+	viewScale = std::max(0.0f, scale);
+	this->minPathSize = minPathSize;
+}
+
+void AdaptiveTesselator::setOcclusionCulling(bool enabled) {
+	occlusionCulling = enabled;
+}
+
+bool AdaptiveTesselator::allowsRigidShortcut(
+	const nsvg::Transform &transform) const {
+	// tolerances and culling depend on the scale we're viewed at, so
+	// scaled vertices would no longer match what we would tesselate.
+	return viewScale <= 0.0f ||
+		std::abs(transform.getScale() - 1.0f) < 1e-4f;
+}
+
+bool AdaptiveTesselator::cullsOcclusion(const MeshRef &fill) const {
+	// culling is only safe if paint cannot change without tesselating
+	// again, as a fill that turns transparent would reveal holes.
+	return occlusionCulling && fill->hasBakedColors();
 }
 
 AdaptiveTesselator::~AdaptiveTesselator() {
@@ -117,9 +267,16 @@ void AdaptiveTesselator::beginTesselate(
 
 	AbstractTesselator::beginTesselate(graphics, scale);
 
-	flattener->configure(scale);
+	if (viewScale > 0.0f) {
+		flattener->configureView(viewScale);
+	} else {
+		flattener->configure(scale);
+	}
 
 	graphics->computeClipPaths(*this);
+
+	coverage.clear();
+	coverage.resize(levels);
 }
 
 bool AdaptiveTesselator::hasFixedSize() const {
@@ -155,34 +312,17 @@ void AdaptiveTesselator::renderStrokes(
 	}
 }
 
-ToveMeshUpdateFlags AdaptiveTesselator::pathToMesh(
-	ToveMeshUpdateFlags update,
+void AdaptiveTesselator::addTesselation(
 	const PathRef &path,
-	int pathIndex,
+	const int pathIndex,
+	const int lod,
 	const PathPaintInd &paint,
+	Tesselation &t,
 	const MeshRef &fill,
-	const MeshRef &line,
-	int &fillIndex,
-	int &lineIndex) {
-
-	assert(fillIndex == fill->getVertexCount());
-	assert(lineIndex == line->getVertexCount());
+	const MeshRef &line) {
 
 	const NSVGshape *shape = path->getNSVG();
 
-	if ((shape->flags & NSVG_FLAGS_VISIBLE) == 0) {
-		return UPDATE_MESH_EVERYTHING;
-	}
-
-	if (shape->fill.type == NSVG_PAINT_NONE &&
-		shape->stroke.type == NSVG_PAINT_NONE) {
-		return UPDATE_MESH_EVERYTHING;
-	}
-
-	Tesselation t;
-	flattener->flatten(path, t);
-	// ClosedPathsFromPolyTree
-
 	int subMeshIndex = 0;
 	for (int i = 0; i < NSVG_PAINTORDER_COUNT && subMeshIndex < 2; i++) {
 		switch (shape->paintOrder[i]) {
@@ -190,9 +330,12 @@ ToveMeshUpdateFlags AdaptiveTesselator::pathToMesh(
 				if (!t.fill.empty() && shape->fill.type != NSVG_PAINT_NONE) {
 
 					clip(graphics, path, t.fill);
+					if (backToFront) {
+						occlude(path, lod, t.fill);
+					}
 
 					const int index0 = fill->getVertexCount();
-					fill->submesh(pathIndex, subMeshIndex)->addClipperPaths(
+					fill->submesh(pathIndex, subMeshIndex, lod)->addClipperPaths(
 						t.fill, flattener->getClipperScale());
 					fill->setFillColor(path, paint, index0, fill->getVertexCount() - index0);
 				}
@@ -201,12 +344,17 @@ ToveMeshUpdateFlags AdaptiveTesselator::pathToMesh(
 			} break;
 			
 			case NSVG_PAINTORDER_STROKE: {
-				if (t.stroke.ChildCount() > 0 &&
+				if (!t.strokeTriangles.empty()) {
+					const int index0 = line->getVertexCount();
+					line->submesh(pathIndex, subMeshIndex, lod)->addTriangles(
+						t.strokeVertices, t.strokeTriangles);
+					line->setLineColor(path, paint, index0, line->getVertexCount() - index0);
+				} else if (t.stroke.ChildCount() > 0 &&
 					shape->stroke.type != NSVG_PAINT_NONE && shape->strokeWidth > 0.0) {
 
 					const int index0 = line->getVertexCount();
 					ClipperPaths holes;
-					renderStrokes(path, &t.stroke, holes, line->submesh(pathIndex, subMeshIndex));
+					renderStrokes(path, &t.stroke, holes, line->submesh(pathIndex, subMeshIndex, lod));
 					line->setLineColor(path, paint, index0, line->getVertexCount() - index0);
 				}
 
@@ -218,6 +366,97 @@ ToveMeshUpdateFlags AdaptiveTesselator::pathToMesh(
 			} break;
 		}
 	}
+}
+
+void AdaptiveTesselator::occlude(
+	const PathRef &path,
+	const int lod,
+	ClipperPaths &fill) {
+
+	ClipperPaths &covered = coverage[lod];
+
+	if (!covered.empty() && !fill.empty()) {
+		ClipperLib::Clipper c;
+		c.AddPaths(fill, ClipperLib::ptSubject, true);
+		c.AddPaths(covered, ClipperLib::ptClip, true);
+		ClipperPaths visible;
+		c.Execute(ClipperLib::ctDifference, visible,
+			ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		fill = std::move(visible);
+	}
+
+	if (!fill.empty() && path->hasOpaqueFill()) {
+		ClipperLib::Clipper c;
+		c.AddPaths(covered, ClipperLib::ptSubject, true);
+		c.AddPaths(fill, ClipperLib::ptClip, true);
+		c.Execute(ClipperLib::ctUnion, covered,
+			ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+	}
+}
+
+ToveMeshUpdateFlags AdaptiveTesselator::pathToMesh(
+	ToveMeshUpdateFlags update,
+	const PathRef &path,
+	int pathIndex,
+	const PathPaintInd &paint,
+	const MeshRef &fill,
+	const MeshRef &line,
+	int &fillIndex,
+	int &lineIndex) {
+
+	assert(fillIndex == fill->getVertexCount());
+	assert(lineIndex == line->getVertexCount());
+
+	const NSVGshape *shape = path->getNSVG();
+
+	if ((shape->flags & NSVG_FLAGS_VISIBLE) == 0) {
+		return UPDATE_MESH_EVERYTHING;
+	}
+
+	if (shape->fill.type == NSVG_PAINT_NONE &&
+		shape->stroke.type == NSVG_PAINT_NONE) {
+		return UPDATE_MESH_EVERYTHING;
+	}
+
+	// screen space size of this path decides about its subdivision.
+	const float *bounds = path->getBounds();
+	const float pixelSize = std::max(
+		bounds[2] - bounds[0], bounds[3] - bounds[1]) /
+		flattener->getUnitsPerPixel();
+	if (pixelSize < minPathSize) {
+		return UPDATE_MESH_EVERYTHING;
+	}
+	flattener->configurePath(pixelSize);
+
+	ClipperPaths polylines;
+	flattener->flatten(path, polylines);
+
+	// overlapping stroke triangles are fine if paint cannot change later.
+	const bool directStrokes = line->hasBakedColors();
+
+	if (levels == 1) {
+		Tesselation t;
+		flattener->tesselate(path, polylines, t, directStrokes);
+		addTesselation(path, pathIndex, 0, paint, t, fill, line);
+	} else {
+		// flatten once, then derive coarser levels by decimation.
+		const PolylineHierarchy hierarchy(polylines);
+		float tolerance = flattener->getTolerance();
+
+		for (int lod = 0; lod < levels; lod++) {
+			ClipperPaths decimated;
+			if (lod == 0) {
+				decimated = polylines;
+			} else {
+				tolerance *= 2.0f;
+				hierarchy.decimate(tolerance, decimated);
+			}
+
+			Tesselation t;
+			flattener->tesselate(path, decimated, t, directStrokes);
+			addTesselation(path, pathIndex, lod, paint, t, fill, line);
+		}
+	}
 
 	fillIndex = fill->getVertexCount();
 	lineIndex = line->getVertexCount();
@@ -248,9 +487,28 @@ ClipperLib::Paths AdaptiveTesselator::toClipPath(
 	return flattened;
 }
 
+uint64_t AdaptiveTesselator::getClipPathKey() const {
+	// bit patterns of the parameters flattening depends on.
+	const float scale = flattener->getClipperScale();
+	const float tolerance = flattener->getTolerance();
+	uint32_t a, b;
+	std::memcpy(&a, &scale, sizeof(a));
+	std::memcpy(&b, &tolerance, sizeof(b));
+	return (uint64_t(a) << 32) | b;
+}
+
+float AdaptiveTesselator::getClipPathScale() const {
+	return flattener->getClipperScale();
+}
+
 RigidTesselator::RigidTesselator(int subdivisions) :
 
-	flattener(subdivisions, 0.0) {
+	flattener(subdivisions, 0.0),
+	asyncTriangulation(false) {
+}
+
+void RigidTesselator::setAsyncTriangulation(bool enabled) {
+	asyncTriangulation = enabled;
 }
 
 ToveMeshUpdateFlags RigidTesselator::pathToMesh(
@@ -307,6 +565,12 @@ ToveMeshUpdateFlags RigidTesselator::pathToMesh(
 	ToveMeshUpdateFlags update = _update;
 	bool trianglesChanged = false;
 
+	// a fill triangulation from a worker thread finished since the
+	// last update? then it replaces the triangles we have been using.
+	const bool swapped = asyncTriangulation &&
+		fillSubmesh->swapPendingTriangulation();
+	bool triangulateAsync = false;
+
 	const float miterLimit = path->getMiterLimit();
 	const bool miter = path->getLineJoin() == TOVE_LINEJOIN_MITER &&
 		miterLimit > 0.0f;
@@ -446,7 +710,12 @@ ToveMeshUpdateFlags RigidTesselator::pathToMesh(
 		if ((update & UPDATE_MESH_TRIANGLES) == 0 &&
 			(update & UPDATE_MESH_AUTO_TRIANGLES)) {
 			if (!fillSubmesh->findCachedTriangulation(trianglesChanged)) {
-				update |= UPDATE_MESH_TRIANGLES;
+				if (asyncTriangulation && fillSubmesh->getIndexCount() > 0) {
+					// keep drawing the previous triangles for now.
+					triangulateAsync = true;
+				} else {
+					update |= UPDATE_MESH_TRIANGLES;
+				}
 			}
 		}
 	} else {
@@ -457,7 +726,7 @@ ToveMeshUpdateFlags RigidTesselator::pathToMesh(
 	}
 
 	if (shape->fill.type != NSVG_PAINT_NONE) {
-		if (update & UPDATE_MESH_TRIANGLES) {
+		if ((update & UPDATE_MESH_TRIANGLES) || triangulateAsync) {
 			const bool debug = tove::report::config.level <= TOVE_REPORT_DEBUG;
 
 			std::chrono::high_resolution_clock::time_point t0;
@@ -465,14 +734,17 @@ ToveMeshUpdateFlags RigidTesselator::pathToMesh(
 				t0 = std::chrono::high_resolution_clock::now();
 			}
 
+			const bool async = triangulateAsync &&
+				(update & UPDATE_MESH_TRIANGLES) == 0;
 			fillSubmesh->triangulateFixedResolutionFill(
-				fillIndex0, path, flattener);
+				fillIndex0, path, flattener, async);
 
 			if (debug) {
 				const int duration = std::chrono::duration_cast<std::chrono::microseconds>(
 					std::chrono::high_resolution_clock::now() - t0).count();
 				std::ostringstream s;
-				s << "[" << *fillSubmesh->getName() << "] new fill triangulation took " <<
+				s << "[" << *fillSubmesh->getName() << "] " <<
+					(async ? "queueing fill triangulation took " : "new fill triangulation took ") <<
 					duration / 1000.0f << " ms";
 				tove::report::report(s.str().c_str(), TOVE_REPORT_DEBUG);
 			}			
@@ -494,7 +766,7 @@ ToveMeshUpdateFlags RigidTesselator::pathToMesh(
 		}
 	}
 
-	if (trianglesChanged) {
+	if (trianglesChanged || swapped) {
 		update |= UPDATE_MESH_TRIANGLES;
 	}
 
@@ -507,8 +779,43 @@ ToveMeshUpdateFlags RigidTesselator::pathToMesh(
 ClipperLib::Paths RigidTesselator::toClipPath(
 	const std::vector<PathRef> &paths) const {
 
-	// clipping is not supported with RididTesselator.
-	return ClipperPaths();
+	// rigid meshes are not clipped geometrically. clip paths are only
+	// triangulated through clipToMesh(), and applied when drawing.
+	const float scale = getClipPathScale();
+	ClipperLib::Paths flattened;
+
+	for (const PathRef &path : paths) {
+		ClipperLib::Paths polygons;
+		const int n = path->getNumSubpaths();
+		for (int i = 0; i < n; i++) {
+			ClipperPath polygon = flattener.toClipperPath(
+				path->getSubpath(i), scale);
+			if (polygon.size() >= 3) {
+				polygons.push_back(std::move(polygon));
+			}
+		}
+		ClipperLib::SimplifyPolygons(
+			polygons, path->getClipperFillType());
+
+		flattened.insert(
+			flattened.end(),
+			std::make_move_iterator(polygons.begin()),
+			std::make_move_iterator(polygons.end()));
+	}
+
+	if (paths.size() > 1) {
+		// children of a clip may overlap. the stencil test in clip.lua
+		// counts each clip once, so triangles must not overlap.
+		ClipperLib::Clipper clipper;
+		clipper.AddPaths(flattened, ClipperLib::ptSubject, true);
+		clipper.Execute(ClipperLib::ctUnion, flattened,
+			ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+	}
+	return flattened;
+}
+
+float RigidTesselator::getClipPathScale() const {
+	return 1024.0f;
 }
 
 bool RigidTesselator::hasFixedSize() const {
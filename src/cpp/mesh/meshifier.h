@@ -18,15 +18,30 @@
 BEGIN_TOVE_NAMESPACE
 
 class AbstractTesselator {
+private:
+	const uint64_t id;
+	static uint64_t nextId;
+
 protected:
 	const Graphics *graphics;
 
+	// set while graphicsToMesh() visits paths from top to bottom, so
+	// that fills hidden under opaque fills above them can be culled.
+	bool backToFront;
+
+	virtual bool cullsOcclusion(const MeshRef &fill) const {
+		return false;
+	}
+
 public:
+	// paths whose bounds miss the optional view rectangle (given in
+	// Graphics space) are not tesselated and contribute no triangles.
 	ToveMeshUpdateFlags graphicsToMesh(
 		Graphics *graphics,
 		ToveMeshUpdateFlags update,
 		const MeshRef &fill,
-		const MeshRef &line);
+		const MeshRef &line,
+		const ToveBounds *view = nullptr);
 
 	virtual void beginTesselate(
 		Graphics *graphics,
@@ -47,9 +62,52 @@ public:
 	virtual ClipperLib::Paths toClipPath(
 		const std::vector<PathRef> &paths) const = 0;
 
+	// toClipPath() gives the same results as long as this key and
+	// the tesselator stay the same.
+	virtual uint64_t getClipPathKey() const {
+		return 0;
+	}
+
+	inline uint64_t getId() const {
+		return id;
+	}
+
+	// clipper scale of the paths returned by toClipPath().
+	virtual float getClipPathScale() const = 0;
+
+	// triangulates the clip path at clipIndex into mesh. used for
+	// tesselators that do not clip geometry themselves, so that clip
+	// paths can be applied when drawing.
+	void clipToMesh(
+		Graphics *graphics,
+		int clipIndex,
+		const MeshRef &mesh);
+
 	virtual bool hasFixedSize() const = 0;
 
-	inline AbstractTesselator() : graphics(nullptr) {
+	// whether vertices may be moved by the given rigid transform instead
+	// of tesselating again.
+	virtual bool allowsRigidShortcut(const nsvg::Transform &transform) const {
+		return true;
+	}
+
+	// tells the tesselator at which scale (pixels per unit) the Graphics
+	// will be drawn. ignored by tesselators with fixed subdivision.
+	virtual void setViewScale(float scale, float minPathSize) {
+	}
+
+	// drops fill geometry hidden under opaque fills. ignored by
+	// tesselators with fixed subdivision.
+	virtual void setOcclusionCulling(bool enabled) {
+	}
+
+	// if enabled, fixed size meshes that miss their triangulation cache
+	// keep their current triangles while a worker thread triangulates.
+	virtual void setAsyncTriangulation(bool enabled) {
+	}
+
+	inline AbstractTesselator() :
+		id(++nextId), graphics(nullptr), backToFront(false) {
 	}
 
 	virtual ~AbstractTesselator() {
@@ -64,14 +122,50 @@ private:
 		ClipperPaths &holes,
 		Submesh *submesh);
 
+	void addTesselation(
+		const PathRef &path,
+		const int pathIndex,
+		const int lod,
+		const PathPaintInd &paint,
+		Tesselation &t,
+		const MeshRef &fill,
+		const MeshRef &line);
+
+	void occlude(
+		const PathRef &path,
+		const int lod,
+		ClipperPaths &fill);
+
 	AbstractAdaptiveFlattener *flattener;
 
+	// number of levels of detail. level 0 is the flattened geometry,
+	// each further level doubles the tolerance via decimation.
+	const int levels;
+
+	// pixels per unit the Graphics will be drawn at, or 0 to derive
+	// tolerances from the tesselator's resolution. paths smaller than
+	// minPathSize pixels are culled.
+	float viewScale;
+	float minPathSize;
+
+	// opaque fills tesselated so far, for each level of detail.
+	bool occlusionCulling;
+	std::vector<ClipperPaths> coverage;
+
+protected:
+	virtual bool cullsOcclusion(const MeshRef &fill) const;
+
 public:
 	AdaptiveTesselator(
-		AbstractAdaptiveFlattener *flattener);
+		AbstractAdaptiveFlattener *flattener,
+		int levels = 1);
 
 	virtual ~AdaptiveTesselator();
 
+	virtual void setViewScale(float scale, float minPathSize);
+
+	virtual void setOcclusionCulling(bool enabled);
+
 	virtual void beginTesselate(
 		Graphics *graphics,
 		float scale);
@@ -89,16 +183,25 @@ public:
 	virtual ClipperLib::Paths toClipPath(
 		const std::vector<PathRef> &paths) const;
 
+	virtual uint64_t getClipPathKey() const;
+
+	virtual float getClipPathScale() const;
+
 	virtual bool hasFixedSize() const;
+
+	virtual bool allowsRigidShortcut(const nsvg::Transform &transform) const;
 };
 
 class RigidTesselator : public AbstractTesselator {
 private:
 	const RigidFlattener flattener;
+	bool asyncTriangulation;
 
 public:
 	RigidTesselator(int subdivisions);
 
+	virtual void setAsyncTriangulation(bool enabled);
+
 	virtual ToveMeshUpdateFlags pathToMesh(
 		ToveMeshUpdateFlags update,
 		const PathRef &path,
@@ -112,6 +215,8 @@ public:
 	virtual ClipperLib::Paths toClipPath(
 		const std::vector<PathRef> &paths) const;
 
+	virtual float getClipPathScale() const;
+
 	virtual bool hasFixedSize() const;
 };
 
@@ -14,7 +14,8 @@
 
 BEGIN_TOVE_NAMESPACE
 
-Partition::Partition(const std::list<TPPLPoly> &convex) {
+void Partition::assign(const std::list<TPPLPoly> &convex) {
+    parts.clear();
     parts.reserve(convex.size());
 
     int maxN = 0;
@@ -97,4 +98,45 @@ bool Partition::check(const Vertices &vertices) {
     return true;
 }
 
+size_t Partition::getByteSize() const {
+    size_t size = parts.capacity() * sizeof(Part) +
+        tempPts.capacity() * sizeof(vec2);
+    for (const Part &part : parts) {
+        size += part.outline.capacity() * sizeof(uint16_t);
+    }
+    return size;
+}
+
+void Partition::serialize(std::ostream &out) const {
+    out << parts.size() << "\n";
+    for (const Part &part : parts) {
+        writeIndices(out, part.outline.data(), part.outline.size());
+    }
+}
+
+bool Partition::deserialize(std::istream &in, int numVertices) {
+    int n;
+    in >> n;
+    if (!in || n < 0) {
+        return false;
+    }
+
+    // don't trust n with allocations, see readIndices().
+    parts.clear();
+    parts.reserve(std::min(n, std::max(numVertices, 1)));
+    size_t maxN = 0;
+    for (int i = 0; i < n; i++) {
+        parts.emplace_back();
+        Part &part = parts.back();
+        if (!readIndices(in, part.outline, numVertices)) {
+            return false;
+        }
+        part.fail = 0;
+        maxN = std::max(maxN, part.outline.size());
+    }
+
+    tempPts.resize(maxN + 2);
+    return true;
+}
+
 END_TOVE_NAMESPACE
@@ -34,13 +34,36 @@ public:
 	inline Partition() {
 	}
 
-	Partition(const std::list<TPPLPoly> &convex);
+	inline Partition(const std::list<TPPLPoly> &convex) {
+		assign(convex);
+	}
+
+	void assign(const std::list<TPPLPoly> &convex);
+
+	inline void clear() {
+		parts.clear();
+	}
+
+	// clears, and frees our buffers if they still hold more than
+	// maxBytes (e.g. before pooling us).
+	inline void trim(size_t maxBytes) {
+		parts.clear();
+		if (getByteSize() > maxBytes) {
+			std::vector<Part>().swap(parts);
+			std::vector<vec2>().swap(tempPts);
+		}
+	}
 
 	inline bool empty() const {
 		return parts.empty();
 	}
 
+	size_t getByteSize() const;
+
 	bool check(const Vertices &vertices);
+
+	void serialize(std::ostream &out) const;
+	bool deserialize(std::istream &in, int numVertices);
 };
 
 END_TOVE_NAMESPACE
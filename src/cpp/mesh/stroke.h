@@ -0,0 +1,223 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_MESH_STROKE
+#define __TOVE_MESH_STROKE 1
+
+#include <vector>
+#include <cmath>
+#include "utils.h"
+
+BEGIN_TOVE_NAMESPACE
+
+// emits stroke triangles directly from flattened polylines, instead of
+// offsetting them with ClipperOffset and triangulating the resulting
+// polygons. segments, joins and caps are separate triangles that may
+// overlap, so this must only be used for opaque strokes.
+
+class PolylineStroker {
+public:
+	struct Style {
+		float halfWidth;
+		int join; // NSVG_JOIN_*
+		int cap; // NSVG_CAP_*
+		float miterLimit;
+		float tolerance; // max. deviation of round joins and caps
+	};
+
+private:
+	const Style style;
+	std::vector<vec2> &vertices;
+	std::vector<ToveVertexIndex> &triangles;
+
+	inline int vertex(float x, float y) {
+		vertices.push_back(vec2(x, y));
+		return vertices.size() - 1;
+	}
+
+	inline void triangle(int a, int b, int c) {
+		triangles.push_back(a);
+		triangles.push_back(b);
+		triangles.push_back(c);
+	}
+
+	inline int arcSteps(float angle) const {
+		const float w = style.halfWidth;
+		const float t = std::min(style.tolerance, w);
+		const float step = t > 0.0f ?
+			2.0f * std::acos(1.0f - t / w) : float(M_PI) / 8.0f;
+		return std::max(1, int(std::ceil(std::abs(angle) / step)));
+	}
+
+	// fan around (cx, cy) from the offset (ox, oy), rotating by angle.
+	void arc(float cx, float cy, float ox, float oy, float angle, int center) {
+		const int steps = arcSteps(angle);
+		const float c = std::cos(angle / steps);
+		const float s = std::sin(angle / steps);
+
+		int previous = vertex(cx + ox, cy + oy);
+		for (int i = 0; i < steps; i++) {
+			const float x = c * ox - s * oy;
+			const float y = s * ox + c * oy;
+			ox = x;
+			oy = y;
+			const int next = vertex(cx + ox, cy + oy);
+			triangle(center, previous, next);
+			previous = next;
+		}
+	}
+
+	void segment(const vec2 &p0, const vec2 &p1, const vec2 &n) {
+		const float w = style.halfWidth;
+		const int i = vertex(p0.x + n.x * w, p0.y + n.y * w);
+		vertex(p0.x - n.x * w, p0.y - n.y * w);
+		vertex(p1.x + n.x * w, p1.y + n.y * w);
+		vertex(p1.x - n.x * w, p1.y - n.y * w);
+		triangle(i, i + 1, i + 2);
+		triangle(i + 1, i + 3, i + 2);
+	}
+
+	// n0 and n1 are the normals of the incoming and outgoing segment.
+	void join(const vec2 &p, const vec2 &n0, const vec2 &n1) {
+		const float cross = n0.x * n1.y - n0.y * n1.x;
+		const float dot = n0.dot(n1);
+		if (std::abs(cross) < 1e-6f && dot > 0.0f) {
+			return; // collinear
+		}
+
+		// the inner side is covered by the overlapping segments.
+		const float side = cross > 0.0f ? -1.0f : 1.0f;
+		const float w = style.halfWidth * side;
+		const float ax = n0.x * w, ay = n0.y * w;
+		const float bx = n1.x * w, by = n1.y * w;
+
+		const int center = vertex(p.x, p.y);
+
+		switch (style.join) {
+			case NSVG_JOIN_ROUND: {
+				arc(p.x, p.y, ax, ay, std::atan2(cross, dot), center);
+			} break;
+
+			case NSVG_JOIN_MITER: {
+				const float mx = n0.x + n1.x;
+				const float my = n0.y + n1.y;
+				const float m = std::sqrt(mx * mx + my * my);
+				// ratio of miter length to stroke width, as in SVG.
+				const float ratio = m > 0.0f ? 2.0f / m : 0.0f;
+				if (m > 0.0f && ratio <= style.miterLimit) {
+					const float l = w * ratio / m;
+					const int a = vertex(p.x + ax, p.y + ay);
+					const int tip = vertex(p.x + mx * l, p.y + my * l);
+					const int b = vertex(p.x + bx, p.y + by);
+					triangle(center, a, tip);
+					triangle(center, tip, b);
+					break;
+				}
+			} // fall through to bevel
+
+			case NSVG_JOIN_BEVEL:
+			default: {
+				const int a = vertex(p.x + ax, p.y + ay);
+				const int b = vertex(p.x + bx, p.y + by);
+				triangle(center, a, b);
+			} break;
+		}
+	}
+
+	// d points away from the line.
+	void cap(const vec2 &p, const vec2 &d) {
+		const float w = style.halfWidth;
+		const vec2 n(-d.y, d.x);
+
+		switch (style.cap) {
+			case NSVG_CAP_ROUND: {
+				const int center = vertex(p.x, p.y);
+				arc(p.x, p.y, n.x * w, n.y * w, -float(M_PI), center);
+			} break;
+
+			case NSVG_CAP_SQUARE: {
+				const vec2 q(p.x + d.x * w, p.y + d.y * w);
+				segment(p, q, n);
+			} break;
+
+			default: {
+			} break;
+		}
+	}
+
+public:
+	inline PolylineStroker(
+		const Style &style,
+		std::vector<vec2> &vertices,
+		std::vector<ToveVertexIndex> &triangles) :
+
+		style(style),
+		vertices(vertices),
+		triangles(triangles) {
+	}
+
+	void stroke(const ClipperPath &path, float scale, bool closed) {
+		std::vector<vec2> points;
+		points.reserve(path.size());
+		for (const ClipperPoint &p : path) {
+			const vec2 q(p.X / scale, p.Y / scale);
+			if (points.empty() ||
+				points.back().x != q.x || points.back().y != q.y) {
+				points.push_back(q);
+			}
+		}
+		if (closed && points.size() > 1 &&
+			points.front().x == points.back().x &&
+			points.front().y == points.back().y) {
+			points.pop_back();
+		}
+
+		const int n = points.size();
+		if (n < 2) {
+			if (n == 1 && !closed) {
+				// zero length lines only get their caps, aligned to
+				// the axes as in SVG.
+				cap(points[0], vec2(-1.0f, 0.0f));
+				cap(points[0], vec2(1.0f, 0.0f));
+			}
+			return;
+		}
+		closed = closed && n > 2;
+
+		const int numSegments = closed ? n : n - 1;
+		std::vector<vec2> normals;
+		normals.reserve(numSegments);
+		for (int i = 0; i < numSegments; i++) {
+			const vec2 &p0 = points[i];
+			const vec2 &p1 = points[(i + 1) % n];
+			const vec2 d = vec2(p1.x - p0.x, p1.y - p0.y).normalized();
+			normals.push_back(vec2(-d.y, d.x));
+			segment(p0, p1, normals.back());
+		}
+
+		for (int i = 1; i < numSegments; i++) {
+			join(points[i], normals[i - 1], normals[i]);
+		}
+
+		if (closed) {
+			join(points[0], normals[numSegments - 1], normals[0]);
+		} else {
+			const vec2 &n0 = normals[0];
+			cap(points[0], vec2(-n0.y, n0.x));
+			const vec2 &n1 = normals[numSegments - 1];
+			cap(points[n - 1], vec2(n1.y, -n1.x));
+		}
+	}
+};
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_MESH_STROKE
@@ -10,6 +10,7 @@
  */
 
 #include "triangles.h"
+#include "../accounting.h"
 #include <sstream>
 #include <chrono>
 
@@ -21,18 +22,32 @@ ToveVertexIndex *TriangleStore::allocate(int n, bool isFinalSize) {
     const int k = (mMode == TRIANGLES_LIST) ? 3 : 1;
     mSize += n * k;
 
-    const int count = isFinalSize ? mSize : nextpow2(mSize);
-    mTriangles = static_cast<ToveVertexIndex*>(realloc(
-        mTriangles, count * sizeof(ToveVertexIndex)));
+    if (mSize > mCapacity) {
+        const int count = isFinalSize ? mSize : nextpow2(mSize);
+        mTriangles = static_cast<ToveVertexIndex*>(realloc(
+            mTriangles, count * sizeof(ToveVertexIndex)));
+        mCapacity = count;
 
-    if (!mTriangles) {
-        TOVE_BAD_ALLOC();
-        return nullptr;
+        if (!mTriangles) {
+            mCapacity = 0;
+            TOVE_BAD_ALLOC();
+            return nullptr;
+        }
     }
 
     return &mTriangles[offset];
 }
 
+void TriangleStore::reset(ToveTrianglesMode mode, int32_t maxCapacity) {
+    mSize = 0;
+    mMode = mode;
+    if (mCapacity > maxCapacity) {
+        free(mTriangles);
+        mTriangles = nullptr;
+        mCapacity = 0;
+    }
+}
+
 void TriangleStore::_add(
     const std::list<TPPLPoly> &triangles,
     bool isFinalSize) {
@@ -84,53 +99,217 @@ void TriangleStore::_add(
     }
 }
 
+void TriangleStore::serialize(std::ostream &out) const {
+    writeIndices(out, mTriangles, mSize);
+}
+
+bool TriangleStore::deserialize(std::istream &in, int numVertices) {
+    std::vector<ToveVertexIndex> indices;
+    if (!readIndices(in, indices, numVertices)) {
+        return false;
+    }
+    const int k = (mMode == TRIANGLES_LIST) ? 3 : 1;
+    if (indices.size() % k != 0) {
+        return false;
+    }
+    mSize = 0;
+    ToveVertexIndex *p = allocate(indices.size() / k, true);
+    if (p && !indices.empty()) {
+        std::memcpy(p, indices.data(),
+            indices.size() * sizeof(ToveVertexIndex));
+    }
+    return true;
+}
+
+
+size_t Triangulation::computeByteSize() const {
+    return sizeof(Triangulation) +
+        triangles.getByteSize() +
+        partition.getByteSize() +
+        vanishing.getByteSize();
+}
+
+void Triangulation::serialize(std::ostream &out) const {
+    out << (keyframe ? 1 : 0) << " " << int(getMode()) << "\n";
+    triangles.serialize(out);
+    partition.serialize(out);
+    vanishing.serialize(out);
+}
+
+Triangulation *Triangulation::deserialize(std::istream &in, int numVertices) {
+    int keyframe, mode;
+    in >> keyframe >> mode;
+    if (!in || (mode != TRIANGLES_LIST && mode != TRIANGLES_STRIP)) {
+        return nullptr;
+    }
+
+    TriangulationPool &pool = TriangulationPool::shared();
+    Triangulation *t = pool.acquire(ToveTrianglesMode(mode));
+    t->keyframe = keyframe != 0;
+
+    if (!t->triangles.deserialize(in, numVertices) ||
+        !t->partition.deserialize(in, numVertices) ||
+        !t->vanishing.deserialize(in, numVertices)) {
+        pool.release(t);
+        return nullptr;
+    }
+
+    return t;
+}
+
+
+// pooled triangulations keep buffers up to this size. idle ones are in
+// no cache, so that no budget accounts for what they hold on to.
+static const int32_t maxPooledIndices = 4096;
+static const size_t maxPooledBytes = maxPooledIndices * sizeof(ToveVertexIndex);
+
+Triangulation *TriangulationPool::acquire(ToveTrianglesMode mode) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Triangulation *t;
+    if (available.empty()) {
+        storage.emplace_back(mode);
+        t = &storage.back();
+    } else {
+        t = available.back();
+        available.pop_back();
+        t->triangles.reset(mode, maxPooledIndices);
+    }
+    return t;
+}
+
+void TriangulationPool::release(Triangulation *t) {
+    t->triangles.reset(t->getMode(), maxPooledIndices);
+    t->partition.trim(maxPooledBytes);
+    t->vanishing.trim(maxPooledBytes);
+    t->useCount = 0;
+    t->keyframe = false;
+    t->byteSize = 0;
+    t->prev = nullptr;
+    t->next = nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    available.push_back(t);
+}
+
+TriangulationPool &TriangulationPool::shared() {
+    // never destroyed, as meshes might get released after static
+    // destruction started.
+    static TriangulationPool *pool = new TriangulationPool();
+    return *pool;
+}
+
+
+TriangleBudget TriangleCache::sGlobalBudget;
 
 TriangleCache::~TriangleCache() {
-    for (Triangulation *t : triangulations) {
-        delete t;
+    TriangulationPool &pool = TriangulationPool::shared();
+    while (head) {
+        Triangulation *t = head;
+        unlink(t);
+        pool.release(t);
     }
 }
 
+void TriangleCache::link(Triangulation *t) {
+    t->prev = nullptr;
+    t->next = head;
+    if (head) {
+        head->prev = t;
+    } else {
+        tail = t;
+    }
+    head = t;
+    count += 1;
+
+    budget->account(t, 1);
+    sGlobalBudget.account(t, 1);
+}
+
+void TriangleCache::unlink(Triangulation *t) {
+    if (t->prev) {
+        t->prev->next = t->next;
+    } else {
+        head = t->next;
+    }
+    if (t->next) {
+        t->next->prev = t->prev;
+    } else {
+        tail = t->prev;
+    }
+    t->prev = nullptr;
+    t->next = nullptr;
+    count -= 1;
+
+    budget->account(t, -1);
+    sGlobalBudget.account(t, -1);
+}
+
+void TriangleCache::updateByteSize(Triangulation *t) {
+    const size_t size = t->computeByteSize();
+    if (size != t->byteSize) {
+        budget->account(t, -1);
+        sGlobalBudget.account(t, -1);
+        t->byteSize = size;
+        budget->account(t, 1);
+        sGlobalBudget.account(t, 1);
+    }
+}
+
+void TriangleCache::push(ToveTrianglesMode mode) {
+    Triangulation *t = TriangulationPool::shared().acquire(mode);
+    t->byteSize = t->computeByteSize();
+    link(t);
+}
+
 void TriangleCache::addAndMakeCurrent(Triangulation *t) {
     if (t->partition.empty()) {
+        TriangulationPool::shared().release(t);
         return;
     }
 
-    if (triangulations.size() + 1 > cacheSize) {
-        evict();
-    }
-
     t->useCount = 0;
-    triangulations.push_front(t);
+    t->byteSize = t->computeByteSize();
+    link(t);
+
+    enforceLimits();
 }
 
-void TriangleCache::evict() {
-    uint64_t minCount = std::numeric_limits<uint64_t>::max();
-    std::list<Triangulation*>::iterator candidate = triangulations.end();
+void TriangleCache::enforceLimits() {
+    while (count > cacheSize && evict(false)) {
+    }
+    while ((budget->exceeded() || sGlobalBudget.exceeded() ||
+        memory::exceeded()) && evict(true)) {
+    }
+}
 
-    for (auto i = triangulations.begin(); i != triangulations.end(); i++) {
-        const Triangulation *t = *i;
-        if (!t->keyframe) {
-            const uint64_t count = t->useCount;
-            if (count < minCount) {
-                minCount = count;
-                candidate = i;
-            }
-        }
+bool TriangleCache::evict(bool overBudget) {
+    // least recently used first. never evicts the current triangulation
+    // or key frames, so that might fail.
+    Triangulation *t = tail;
+    while (t && (t == head || t->keyframe)) {
+        t = t->prev;
+    }
+    if (!t) {
+        return false;
     }
 
-    if (candidate != triangulations.end()) {
-        delete *candidate;
-        triangulations.erase(candidate);
+    unlink(t);
+    TriangulationPool::shared().release(t);
+
+    budget->stats.numEvicted += 1;
+    sGlobalBudget.stats.numEvicted += 1;
+    if (overBudget) {
+        budget->stats.numEvictedOverBudget += 1;
+        sGlobalBudget.stats.numEvictedOverBudget += 1;
     }
+    return true;
 }
 
 bool TriangleCache::findCachedTriangulation(
     const Vertices &vertices,
     bool &trianglesChanged) {
     
-    const int n = triangulations.size();
-    if (n == 0) {
+    if (!head) {
         return false;
     }
 
@@ -144,14 +323,13 @@ bool TriangleCache::findCachedTriangulation(
     bool good = false;
     int switchedTo = 0;
 
-    for (auto i = triangulations.begin(); i != triangulations.end(); i++) {
-        Triangulation *t = *i;
+    for (Triangulation *t = head; t; t = t->next) {
         if (t->check(vertices)) {
             trianglesChanged = switchedTo > 0;
             good = true;
             t->useCount++;
             if (trianglesChanged) {
-                makeCurrent(i);
+                makeCurrent(t);
             }
             break;
         }
@@ -179,4 +357,49 @@ bool TriangleCache::findCachedTriangulation(
     return good;
 }
 
+void TriangleCache::serialize(std::ostream &out) const {
+    // the current triangulation comes first.
+    out << cacheSize << " " << count << "\n";
+    for (const Triangulation *t = head; t; t = t->next) {
+        t->serialize(out);
+    }
+}
+
+bool TriangleCache::deserialize(std::istream &in, int numVertices,
+    DeserializedTriangulations &loaded) {
+
+    int size, n;
+    in >> size >> n;
+    if (!in || n < 0) {
+        return false;
+    }
+
+    loaded.cacheSize = std::max(size, n);
+    for (int i = 0; i < n; i++) {
+        Triangulation *t = Triangulation::deserialize(in, numVertices);
+        if (!t) {
+            return false;
+        }
+        loaded.triangulations.push_back(t);
+    }
+    return true;
+}
+
+void TriangleCache::assign(DeserializedTriangulations &loaded) {
+    TriangulationPool &pool = TriangulationPool::shared();
+    while (head) {
+        Triangulation *t = head;
+        unlink(t);
+        pool.release(t);
+    }
+    // link in reverse, so that the first one becomes current.
+    auto &triangulations = loaded.triangulations;
+    for (auto i = triangulations.rbegin(); i != triangulations.rend(); i++) {
+        (*i)->byteSize = (*i)->computeByteSize();
+        link(*i);
+    }
+    triangulations.clear();
+    cacheSize = std::max(int(cacheSize), loaded.cacheSize);
+}
+
 END_TOVE_NAMESPACE
@@ -16,6 +16,8 @@
 #include "area.h"
 #include "../interface.h"
 #include "../utils.h"
+#include <deque>
+#include <mutex>
 
 BEGIN_TOVE_NAMESPACE
 
@@ -35,11 +37,11 @@ inline ToveVertexIndex ToLoveVertexMapIndex(ToveVertexIndex i) {
 class TriangleStore {
 private:
 	int32_t mSize;
+	int32_t mCapacity;
 	ToveVertexIndex *mTriangles;
+	ToveTrianglesMode mMode;
 
 public:
-	const ToveTrianglesMode mMode;
-
 	ToveVertexIndex *allocate(int n, bool isFinalSize = false);
 
 private:
@@ -54,7 +56,7 @@ private:
 
 public:
 	inline TriangleStore(ToveTrianglesMode mode) :
-		mSize(0), mTriangles(nullptr), mMode(mode) {
+		mSize(0), mCapacity(0), mTriangles(nullptr), mMode(mode) {
 	}
 
 	inline ~TriangleStore() {
@@ -63,12 +65,6 @@ public:
 		}
 	}
 
-	inline TriangleStore(const std::list<TPPLPoly> &triangles) :
-		mSize(0), mTriangles(nullptr), mMode(TRIANGLES_LIST) {
-
-		_add(triangles, true);
-	}
-
 	inline void add(const std::list<TPPLPoly> &triangles) {
 		assert(mMode == TRIANGLES_LIST);
 		_add(triangles, false);
@@ -83,6 +79,10 @@ public:
 		mSize = 0;
 	}
 
+	// empties the store for reuse in the given mode. buffers above
+	// maxCapacity indices are freed, smaller ones are kept.
+	void reset(ToveTrianglesMode mode, int32_t maxCapacity);
+
 	inline int32_t size() const {
 		return mSize;
 	}
@@ -91,6 +91,13 @@ public:
 		return mMode;
 	}
 
+	inline size_t getByteSize() const {
+		return mCapacity * sizeof(ToveVertexIndex);
+	}
+
+	void serialize(std::ostream &out) const;
+	bool deserialize(std::istream &in, int numVertices);
+
 	inline void copy(
 		ToveVertexIndex *indices,
 		int32_t indexCount) const {
@@ -105,18 +112,13 @@ public:
 };
 
 struct Triangulation {
-	inline Triangulation(ToveTrianglesMode mode) : triangles(mode) {
-	}
-
-	inline Triangulation(
-		const std::list<TPPLPoly> &convex,
-		VanishingTriangles &&vanishing) :
-		
-		partition(convex),
-		triangles(TRIANGLES_LIST),
+	inline Triangulation(ToveTrianglesMode mode) :
+		triangles(mode),
 		useCount(0),
 		keyframe(false),
-		vanishing(vanishing) {
+		byteSize(0),
+		prev(nullptr),
+		next(nullptr) {
 	}
 
 	inline ToveTrianglesMode getMode() const {
@@ -127,36 +129,131 @@ struct Triangulation {
 		return vanishing.check(vertices) && partition.check(vertices);
 	}
 
+	size_t computeByteSize() const;
+
+	void serialize(std::ostream &out) const;
+
+	// returns nullptr if the input is broken or does not fit numVertices.
+	static Triangulation *deserialize(std::istream &in, int numVertices);
+
 	Partition partition;
 	TriangleStore triangles;
 	uint64_t useCount;
 	bool keyframe;
 	VanishingTriangles vanishing;
+
+	// bytes accounted for in cache budgets.
+	size_t byteSize;
+
+	// links in the cache's LRU list, most recently used first.
+	Triangulation *prev;
+	Triangulation *next;
+};
+
+// triangulations get allocated from one pool, so that animating many
+// meshes does not keep on allocating and freeing them. objects live in
+// chunks of contiguous storage and never move. thread safe, as worker
+// threads triangulate as well.
+
+class TriangulationPool {
+	std::mutex mutex;
+	std::deque<Triangulation> storage;
+	std::vector<Triangulation*> available;
+
+public:
+	Triangulation *acquire(ToveTrianglesMode mode);
+	void release(Triangulation *t);
+
+	static TriangulationPool &shared();
+};
+
+// triangulations read by TriangleCache::deserialize() that no cache
+// owns yet. hands them back to the pool unless they got assigned.
+struct DeserializedTriangulations {
+	int cacheSize;
+	std::vector<Triangulation*> triangulations;
+
+	inline DeserializedTriangulations() : cacheSize(0) {
+	}
+
+	DeserializedTriangulations(const DeserializedTriangulations&) = delete;
+
+	inline DeserializedTriangulations(DeserializedTriangulations &&other) noexcept :
+		cacheSize(other.cacheSize),
+		triangulations(std::move(other.triangulations)) {
+		other.triangulations.clear();
+	}
+
+	inline ~DeserializedTriangulations() {
+		for (Triangulation *t : triangulations) {
+			TriangulationPool::shared().release(t);
+		}
+	}
+};
+
+// memory used by triangle caches, and how much they are allowed to use.
+struct TriangleBudget {
+	ToveTriangleCacheStats stats;
+
+	inline TriangleBudget() {
+		stats.bytes = 0;
+		stats.budget = 0;
+		stats.numTriangulations = 0;
+		stats.numEvicted = 0;
+		stats.numEvictedOverBudget = 0;
+	}
+
+	inline bool exceeded() const {
+		return stats.budget > 0 && stats.bytes > stats.budget;
+	}
+
+	inline void account(const Triangulation *t, int sign) {
+		stats.bytes += sign * int64_t(t->byteSize);
+		stats.numTriangulations += sign;
+	}
 };
 
 class TriangleCache {
 private:
 	NameRef name;
-	std::list<Triangulation*> triangulations;
+
+	// intrusive LRU list; head is the current triangulation.
+	Triangulation *head;
+	Triangulation *tail;
+	int16_t count;
 
 	int16_t cacheSize;
 
-	void evict();
+	// budget of the mesh we belong to; global budget is shared by all.
+	TriangleBudget * const budget;
+	static TriangleBudget sGlobalBudget;
+
+	void link(Triangulation *t);
+	void unlink(Triangulation *t);
+	bool evict(bool overBudget);
+	void enforceLimits();
+
+	// updates the byte size of t, e.g. after adding triangles to it.
+	void updateByteSize(Triangulation *t);
 
 	inline Triangulation *currentTriangulation() const {
-		assert(!triangulations.empty());
-		return triangulations.front();
+		assert(head);
+		return head;
 	}
 
-	inline void makeCurrent(std::list<Triangulation*>::iterator i) {
-		if (i != triangulations.begin()) {
-			triangulations.splice(triangulations.begin(), triangulations, i, std::next(i));
+	inline void makeCurrent(Triangulation *t) {
+		if (t != head) {
+			unlink(t);
+			link(t);
 		}
 	}
 
+	void push(ToveTrianglesMode mode);
+
 public:
-	inline TriangleCache(const NameRef &name) :
-		name(name), cacheSize(2) {
+	inline TriangleCache(const NameRef &name, TriangleBudget *budget) :
+		name(name), head(nullptr), tail(nullptr), count(0),
+		cacheSize(2), budget(budget) {
 	}
 
 	~TriangleCache();
@@ -168,14 +265,14 @@ public:
 	}
 
 	inline void cacheKeyFrame() {
-		if (!triangulations.empty()) {
+		if (head) {
 			currentTriangulation()->keyframe = true;
 			cacheSize += 1;
 		}
 	}
 
 	inline bool hasMode(ToveTrianglesMode mode) {
-		if (triangulations.empty()) {
+		if (!head) {
 			return false;
 		} else {
 			return currentTriangulation()->getMode() == mode;
@@ -183,37 +280,44 @@ public:
 	}
 
 	inline ToveVertexIndex *allocate(ToveTrianglesMode mode, int n) {
-		if (triangulations.empty()) {
-			triangulations.push_back(new Triangulation(mode));
+		if (!head) {
+			push(mode);
 		} else {
 			assert(hasMode(mode));
 		}
-		return currentTriangulation()->triangles.allocate(n);
+		Triangulation *t = currentTriangulation();
+		ToveVertexIndex *indices = t->triangles.allocate(n);
+		updateByteSize(t);
+		return indices;
 	}
 
 	inline void add(const std::list<TPPLPoly> &triangles) {
-		if (triangulations.empty()) {
-			triangulations.push_back(new Triangulation(TRIANGLES_LIST));
+		if (!head) {
+			push(TRIANGLES_LIST);
 		}
-		currentTriangulation()->triangles.add(triangles);
+		Triangulation *t = currentTriangulation();
+		t->triangles.add(triangles);
+		updateByteSize(t);
 	}
 
 	inline void add(const std::vector<ToveVertexIndex> &triangles,
 		ToveVertexIndex i0) {
-		if (triangulations.empty()) {
-			triangulations.push_back(new Triangulation(TRIANGLES_LIST));
+		if (!head) {
+			push(TRIANGLES_LIST);
 		}
-		currentTriangulation()->triangles.add(triangles, i0);
+		Triangulation *t = currentTriangulation();
+		t->triangles.add(triangles, i0);
+		updateByteSize(t);
 	}
 
 	inline void clear() {
-		if (!triangulations.empty()) {
+		if (head) {
 			currentTriangulation()->triangles.clear();
 		}
 	}
 
 	inline ToveTrianglesMode getIndexMode() const {
-		if (!triangulations.empty()) {
+		if (head) {
 			return currentTriangulation()->triangles.mode();
 		} else {
 			return TRIANGLES_LIST;
@@ -221,7 +325,7 @@ public:
 	}
 
 	inline int32_t getIndexCount() const {
-		if (!triangulations.empty()) {
+		if (head) {
 			return currentTriangulation()->triangles.size();
 		} else {
 			return 0;
@@ -232,7 +336,7 @@ public:
 		ToveVertexIndex *indices,
 		int32_t indexCount) const {
 
-		if (!triangulations.empty()) {
+		if (head) {
 			const auto &t = currentTriangulation()->triangles;
 			t.copy(indices, indexCount);
 		}
@@ -240,6 +344,20 @@ public:
 
 	bool findCachedTriangulation(
 		const Vertices &vertices, bool &trianglesChanged);
+
+	void serialize(std::ostream &out) const;
+
+	// reads triangulations written by serialize() without touching
+	// any cache. returns false if the input is broken.
+	static bool deserialize(std::istream &in, int numVertices,
+		DeserializedTriangulations &loaded);
+
+	// replaces all cached triangulations with (and takes) loaded ones.
+	void assign(DeserializedTriangulations &loaded);
+
+	static inline TriangleBudget &getGlobalBudget() {
+		return sGlobalBudget;
+	}
 };
 
 END_TOVE_NAMESPACE
@@ -14,6 +14,9 @@
 
 #include "../common.h"
 #include "../utils.h"
+#include <istream>
+#include <ostream>
+#include <vector>
 
 BEGIN_TOVE_NAMESPACE
 
@@ -184,6 +187,39 @@ inline float ray_circle(
 }
 #endif
 
+// text serialization of index lists (as used for triangle caches).
+template<typename T>
+inline void writeIndices(std::ostream &out, const T *indices, int n) {
+	out << n;
+	for (int i = 0; i < n; i++) {
+		out << " " << int(indices[i]);
+	}
+	out << "\n";
+}
+
+// reads indices written by writeIndices(). fails on indices that do
+// not refer to one of numVertices vertices. as the count might be
+// broken, we only grow with indices that are actually there.
+template<typename T>
+inline bool readIndices(std::istream &in, std::vector<T> &indices, int numVertices) {
+	int n;
+	in >> n;
+	if (!in || n < 0) {
+		return false;
+	}
+	indices.clear();
+	indices.reserve(std::min(n, 6 * std::max(numVertices, 1)));
+	for (int i = 0; i < n; i++) {
+		int index;
+		in >> index;
+		if (!in || index < 0 || index >= numVertices) {
+			return false;
+		}
+		indices.push_back(index);
+	}
+	return true;
+}
+
 END_TOVE_NAMESPACE
 
 #endif // __TOVE_MESH_UTILS
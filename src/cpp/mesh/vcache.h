@@ -0,0 +1,263 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_MESH_VCACHE
+#define __TOVE_MESH_VCACHE 1
+
+#include <vector>
+#include <algorithm>
+#include "../common.h"
+
+BEGIN_TOVE_NAMESPACE
+
+// reorders a triangle list for the post-transform vertex cache, using
+// "Tipsify" from Sander, Nehab and Barczak, "Fast Triangle Reordering
+// for Vertex Locality and Reduced Overdraw" (2007). runs in linear time.
+
+class VertexCacheOptimizer {
+	const int cacheSize;
+
+	ToveVertexIndex base;
+	std::vector<int32_t> adjacencyStart;
+	std::vector<int32_t> adjacency;
+	std::vector<int32_t> live;
+	std::vector<int32_t> cacheTime;
+	std::vector<bool> emitted;
+	std::vector<int32_t> deadEnd;
+	std::vector<int32_t> candidates;
+
+	void buildAdjacency(const ToveVertexIndex *indices, int32_t n) {
+		ToveVertexIndex lo = indices[0], hi = indices[0];
+		for (int32_t i = 1; i < n; i++) {
+			lo = std::min(lo, indices[i]);
+			hi = std::max(hi, indices[i]);
+		}
+		base = lo;
+		const int32_t numVertices = int32_t(hi) - int32_t(lo) + 1;
+
+		live.assign(numVertices, 0);
+		for (int32_t i = 0; i < n; i++) {
+			live[indices[i] - base]++;
+		}
+
+		adjacencyStart.resize(numVertices + 1);
+		adjacencyStart[0] = 0;
+		for (int32_t v = 0; v < numVertices; v++) {
+			adjacencyStart[v + 1] = adjacencyStart[v] + live[v];
+		}
+
+		adjacency.resize(n);
+		std::vector<int32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+		for (int32_t i = 0; i < n; i++) {
+			adjacency[fill[indices[i] - base]++] = i / 3;
+		}
+
+		cacheTime.assign(numVertices, 0);
+		emitted.assign(n / 3, false);
+		deadEnd.clear();
+	}
+
+	int32_t skipDeadEnd(int32_t &cursor) {
+		while (!deadEnd.empty()) {
+			const int32_t d = deadEnd.back();
+			deadEnd.pop_back();
+			if (live[d] > 0) {
+				return d;
+			}
+		}
+		const int32_t numVertices = live.size();
+		while (cursor < numVertices) {
+			if (live[cursor] > 0) {
+				return cursor;
+			}
+			cursor++;
+		}
+		return -1;
+	}
+
+	int32_t nextVertex(int32_t time, int32_t &cursor) {
+		int32_t best = -1;
+		int32_t bestPriority = -1;
+		for (int32_t v : candidates) {
+			if (live[v] > 0) {
+				// prefer vertices that are still in the cache and will
+				// stay there while their remaining triangles get emitted.
+				int32_t priority = 0;
+				if (time - cacheTime[v] + 2 * live[v] <= cacheSize) {
+					priority = time - cacheTime[v];
+				}
+				if (priority > bestPriority) {
+					bestPriority = priority;
+					best = v;
+				}
+			}
+		}
+		return best >= 0 ? best : skipDeadEnd(cursor);
+	}
+
+public:
+	VertexCacheOptimizer(int cacheSize = 16) : cacheSize(cacheSize) {
+	}
+
+	// reorders the n indices of the given triangle list in place.
+	void optimize(ToveVertexIndex *indices, int32_t n) {
+		if (n < 6) {
+			return;
+		}
+
+		buildAdjacency(indices, n);
+		std::vector<ToveVertexIndex> out;
+		out.reserve(n);
+
+		int32_t time = cacheSize + 1;
+		int32_t cursor = 0;
+		int32_t f = 0;
+
+		while (f >= 0) {
+			candidates.clear();
+			for (int32_t j = adjacencyStart[f]; j < adjacencyStart[f + 1]; j++) {
+				const int32_t t = adjacency[j];
+				if (emitted[t]) {
+					continue;
+				}
+				for (int k = 0; k < 3; k++) {
+					const ToveVertexIndex index = indices[3 * t + k];
+					const int32_t v = index - base;
+					out.push_back(index);
+					deadEnd.push_back(v);
+					candidates.push_back(v);
+					live[v]--;
+					if (time - cacheTime[v] > cacheSize) {
+						cacheTime[v] = time++;
+					}
+				}
+				emitted[t] = true;
+			}
+			f = nextVertex(time, cursor);
+		}
+
+		std::copy(out.begin(), out.end(), indices);
+	}
+};
+
+// greedily converts a triangle list into one triangle strip, joining
+// separate strips through degenerate triangles (LÖVE has no primitive
+// restart). the winding of each triangle is kept, so that the strip
+// also works with face culling.
+
+class Stripifier {
+	const ToveVertexIndex *indices;
+	int32_t numTriangles;
+	std::vector<bool> used;
+
+	// (vertex, triangle) incidences sorted by vertex, for finding neighbors.
+	std::vector<std::pair<ToveVertexIndex, int32_t>> byVertex;
+
+	inline bool hasDirectedEdge(int32_t t, ToveVertexIndex a, ToveVertexIndex b) const {
+		const ToveVertexIndex *p = indices + 3 * t;
+		for (int k = 0; k < 3; k++) {
+			if (p[k] == a && p[(k + 1) % 3] == b) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	inline ToveVertexIndex third(int32_t t, ToveVertexIndex a, ToveVertexIndex b) const {
+		const ToveVertexIndex *p = indices + 3 * t;
+		for (int k = 0; k < 3; k++) {
+			if (p[k] != a && p[k] != b) {
+				return p[k];
+			}
+		}
+		return p[0];
+	}
+
+	// finds an unused triangle that continues a strip ending in a, b.
+	// the new triangle's winding depends on its parity in the strip.
+	int32_t findNext(ToveVertexIndex a, ToveVertexIndex b, bool odd) const {
+		const auto range = std::equal_range(
+			byVertex.begin(), byVertex.end(),
+			std::make_pair(b, int32_t(0)),
+			[] (const std::pair<ToveVertexIndex, int32_t> &x,
+				const std::pair<ToveVertexIndex, int32_t> &y) {
+				return x.first < y.first;
+			});
+		for (auto i = range.first; i != range.second; i++) {
+			const int32_t t = i->second;
+			if (!used[t] && (odd ?
+				hasDirectedEdge(t, b, a) : hasDirectedEdge(t, a, b))) {
+				return t;
+			}
+		}
+		return -1;
+	}
+
+public:
+	// appends a strip for the n indices of the given list to strip.
+	void stripify(
+		const ToveVertexIndex *list,
+		int32_t n,
+		std::vector<ToveVertexIndex> &strip) {
+
+		indices = list;
+		numTriangles = n / 3;
+		used.assign(numTriangles, false);
+
+		byVertex.clear();
+		byVertex.reserve(n);
+		for (int32_t i = 0; i < n; i++) {
+			byVertex.push_back(std::make_pair(list[i], i / 3));
+		}
+		std::sort(byVertex.begin(), byVertex.end());
+
+		// follows the (cache optimized) list order when starting strips.
+		for (int32_t t = 0; t < numTriangles; t++) {
+			if (used[t]) {
+				continue;
+			}
+			used[t] = true;
+
+			const ToveVertexIndex *p = list + 3 * t;
+			if (!strip.empty()) {
+				// degenerate triangles, padded so that the new strip
+				// starts at an even position and keeps its winding.
+				const bool odd = (strip.size() & 1) != 0;
+				const ToveVertexIndex last = strip.back();
+				strip.push_back(last);
+				strip.push_back(p[0]);
+				if (odd) {
+					strip.push_back(p[0]);
+				}
+			}
+
+			const size_t start = strip.size();
+			strip.push_back(p[0]);
+			strip.push_back(p[1]);
+			strip.push_back(p[2]);
+
+			while (true) {
+				const size_t m = strip.size();
+				const bool odd = ((m - start) & 1) != 0;
+				const int32_t next = findNext(strip[m - 2], strip[m - 1], odd);
+				if (next < 0) {
+					break;
+				}
+				used[next] = true;
+				strip.push_back(third(next, strip[m - 2], strip[m - 1]));
+			}
+		}
+	}
+};
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_MESH_VCACHE
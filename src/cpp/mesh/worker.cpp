@@ -0,0 +1,51 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#include "worker.h"
+
+BEGIN_TOVE_NAMESPACE
+
+Worker::Worker() : thread(&Worker::run, this) {
+}
+
+void Worker::run() {
+	while (true) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this] { return !jobs.empty(); });
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		try {
+			job();
+		} catch (...) {
+			// jobs hand back their own errors.
+		}
+	}
+}
+
+void Worker::submit(std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(std::move(job));
+	}
+	condition.notify_one();
+}
+
+Worker &Worker::shared() {
+	// never destroyed, as the thread never stops and meshes might get
+	// released after static destruction started.
+	static Worker *worker = new Worker();
+	return *worker;
+}
+
+END_TOVE_NAMESPACE
@@ -0,0 +1,46 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_MESH_WORKER
+#define __TOVE_MESH_WORKER 1
+
+#include "../common.h"
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+BEGIN_TOVE_NAMESPACE
+
+// one persistent thread that runs jobs in the order they got submitted,
+// so that background triangulations don't start a thread each. jobs
+// must not report, and exceptions they throw are swallowed.
+
+class Worker {
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::function<void()>> jobs;
+	std::thread thread;
+
+	void run();
+
+public:
+	Worker();
+
+	void submit(std::function<void()> job);
+
+	static Worker &shared();
+};
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_MESH_WORKER
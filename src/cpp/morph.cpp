@@ -0,0 +1,230 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#include "morph.h"
+#include "graphics.h"
+#include "utils.h"
+#include <sstream>
+#include <algorithm>
+
+BEGIN_TOVE_NAMESPACE
+
+void MorphPlan::describe(const GraphicsRef &graphics, Entry &entry) {
+	entry.pathSizes.clear();
+	entry.curves.clear();
+
+	const int numPaths = graphics->getNumPaths();
+	entry.pathSizes.reserve(numPaths);
+	for (int i = 0; i < numPaths; i++) {
+		const auto &subpaths = graphics->getPath(i)->getSubpaths();
+		entry.pathSizes.push_back(subpaths.size());
+		for (const SubpathRef &subpath : subpaths) {
+			entry.curves.push_back(subpath->getNumCurves(false));
+		}
+	}
+}
+
+bool MorphPlan::analyze(const std::vector<GraphicsRef> &graphics) {
+	entries.clear();
+	rotations.clear();
+
+	const int n = graphics.size();
+	if (n < 2) {
+		return false;
+	}
+
+	const int numPaths = graphics[0]->getNumPaths();
+	for (int i = 0; i < n; i++) {
+		if (graphics[i]->getNumPaths() != numPaths) {
+			return false;
+		}
+	}
+
+	entries.resize(n);
+	for (int i = 0; i < n; i++) {
+		describe(graphics[i], entries[i]);
+		entries[i].factors.resize(entries[i].curves.size(), 1);
+	}
+
+	// same decisions as Path::morphify and Subpath::morphify: paths with
+	// differing subpath counts and empty subpaths are left alone.
+
+	std::vector<int> offsets(n, 0);
+	std::vector<int> curves(n);
+
+	for (int j = 0; j < numPaths; j++) {
+		const int numSubpaths = entries[0].pathSizes[j];
+		bool compatible = true;
+		for (int i = 1; i < n; i++) {
+			compatible = compatible &&
+				entries[i].pathSizes[j] == numSubpaths;
+		}
+
+		if (compatible) {
+			for (int k = 0; k < numSubpaths; k++) {
+				bool empty = false;
+				for (int i = 0; i < n; i++) {
+					curves[i] = entries[i].curves[offsets[i] + k];
+					empty = empty || curves[i] < 1;
+				}
+				if (!empty) {
+					const int common = lcm(curves);
+					for (int i = 0; i < n; i++) {
+						entries[i].factors[offsets[i] + k] = common / curves[i];
+					}
+				}
+			}
+		}
+
+		for (int i = 0; i < n; i++) {
+			offsets[i] += entries[i].pathSizes[j];
+		}
+	}
+
+	return true;
+}
+
+bool MorphPlan::apply(const std::vector<GraphicsRef> &graphics) const {
+	const int n = graphics.size();
+	if (n != entries.size()) {
+		tove::report::warn("morph plan does not match number of graphics.");
+		return false;
+	}
+
+	Entry entry;
+	for (int i = 0; i < n; i++) {
+		describe(graphics[i], entry);
+		if (entry.pathSizes != entries[i].pathSizes ||
+			entry.curves != entries[i].curves) {
+			if (tove::report::warnings()) {
+				std::ostringstream message;
+				message << "morph plan does not match graphics " << (i + 1) << ".";
+				tove::report::warn(message.str().c_str());
+			}
+			return false;
+		}
+	}
+
+	for (int i = 0; i < n; i++) {
+		const GraphicsRef &g = graphics[i];
+		const std::vector<int> &factors = entries[i].factors;
+		ObserverBatch batch;
+		int k = 0;
+		const int numPaths = g->getNumPaths();
+		for (int j = 0; j < numPaths; j++) {
+			for (const SubpathRef &subpath : g->getPath(j)->getSubpaths()) {
+				subpath->refine(factors[k++]);
+			}
+		}
+	}
+
+	for (const Rotation &r : rotations) {
+		graphics[r.graphics]->rotate(r.what, r.k);
+	}
+
+	return true;
+}
+
+bool MorphPlan::rotate(const GraphicsRef &graphics, int index, ToveElementType what, int k) {
+	if (index < 0 || index >= entries.size()) {
+		return false;
+	}
+	graphics->rotate(what, k);
+	rotations.push_back(Rotation{index, what, k});
+	return true;
+}
+
+const char *MorphPlan::serialize() {
+	std::ostringstream out;
+	out << "tove-morph-plan 1\n";
+	out << entries.size() << " " << rotations.size() << "\n";
+	for (const Entry &entry : entries) {
+		out << entry.pathSizes.size() << "\n";
+		int k = 0;
+		for (int size : entry.pathSizes) {
+			out << size;
+			for (int i = 0; i < size; i++, k++) {
+				out << " " << entry.curves[k] << " " << entry.factors[k];
+			}
+			out << "\n";
+		}
+	}
+	for (const Rotation &r : rotations) {
+		out << r.graphics << " " << int(r.what) << " " << r.k << "\n";
+	}
+	serialized = out.str();
+	return serialized.c_str();
+}
+
+bool MorphPlan::deserialize(const char *s) {
+	std::istringstream in(s);
+
+	std::string magic;
+	int version;
+	in >> magic >> version;
+	if (!in || magic != "tove-morph-plan" || version != 1) {
+		return false;
+	}
+
+	int numEntries, numRotations;
+	in >> numEntries >> numRotations;
+	if (!in || numEntries < 0 || numRotations < 0) {
+		return false;
+	}
+
+	// counts might be broken, so we only grow with data that is actually
+	// there, and only replace our plan once all of it got parsed.
+	std::vector<Entry> parsedEntries;
+	parsedEntries.reserve(std::min(numEntries, 1024));
+	for (int e = 0; e < numEntries; e++) {
+		parsedEntries.emplace_back();
+		Entry &entry = parsedEntries.back();
+		int numPaths;
+		in >> numPaths;
+		if (!in || numPaths < 0) {
+			return false;
+		}
+		for (int j = 0; j < numPaths; j++) {
+			int size;
+			in >> size;
+			if (!in || size < 0) {
+				return false;
+			}
+			entry.pathSizes.push_back(size);
+			for (int i = 0; i < size; i++) {
+				int curves, factor;
+				in >> curves >> factor;
+				if (!in || factor < 1) {
+					return false;
+				}
+				entry.curves.push_back(curves);
+				entry.factors.push_back(factor);
+			}
+		}
+	}
+
+	std::vector<Rotation> parsedRotations;
+	for (int i = 0; i < numRotations; i++) {
+		int index, what, k;
+		in >> index >> what >> k;
+		if (!in || index < 0 || index >= numEntries ||
+			what < TOVE_POINT || what > TOVE_PATH) {
+			return false;
+		}
+		parsedRotations.push_back(Rotation{index, ToveElementType(what), k});
+	}
+
+	entries.swap(parsedEntries);
+	rotations.swap(parsedRotations);
+	return true;
+}
+
+END_TOVE_NAMESPACE
@@ -0,0 +1,56 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_MORPH
+#define __TOVE_MORPH 1
+
+#include "common.h"
+#include <vector>
+
+BEGIN_TOVE_NAMESPACE
+
+// records what Graphics::morphify decides for a set of Graphics (i.e.
+// how much to refine each subpath), plus rotations added afterwards, so
+// that this can be re-applied to structurally identical Graphics (e.g.
+// fresh clones) without analyzing them again.
+
+class MorphPlan {
+	struct Rotation {
+		int graphics;
+		ToveElementType what;
+		int k;
+	};
+
+	struct Entry {
+		std::vector<int> pathSizes; // number of subpaths per path
+		std::vector<int> curves; // number of curves per subpath
+		std::vector<int> factors; // refine factor per subpath
+	};
+
+	std::vector<Entry> entries;
+	std::vector<Rotation> rotations;
+	std::string serialized;
+
+	static void describe(const GraphicsRef &graphics, Entry &entry);
+
+public:
+	bool analyze(const std::vector<GraphicsRef> &graphics);
+	bool apply(const std::vector<GraphicsRef> &graphics) const;
+
+	bool rotate(const GraphicsRef &graphics, int index, ToveElementType what, int k);
+
+	const char *serialize();
+	bool deserialize(const char *s);
+};
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_MORPH
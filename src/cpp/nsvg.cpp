@@ -12,6 +12,7 @@
 #include "nsvg.h"
 #include "utils.h"
 #include "palette.h"
+#include "accounting.h"
 
 #include "../thirdparty/robin-map/include/tsl/robin_map.h"
 #include "../thirdparty/tinyxml2/tinyxml2.h"
@@ -35,6 +36,7 @@ namespace nsvg {
 thread_local NSVGparser *_parser = nullptr;
 thread_local NSVGrasterizer *rasterizer = nullptr;
 thread_local ToveRasterizeSettings defaultSettings = {-1.0f, -1.0f};
+thread_local size_t accountedBytes = 0;
 
 // scoping the locale should no longer be necessary.
 #define NSVG_SCOPE_LOCALE 0
@@ -345,6 +347,25 @@ static NSVGparser *getNSVGparser() {
 	return _parser;
 }
 
+// our parser and rasterizer grow their buffers as needed, and are never
+// freed. we only approximate their size, as we skip smaller allocations.
+static void accountParserMemory() {
+	size_t size = 0;
+	if (_parser) {
+		size += sizeof(NSVGparser) + _parser->cpts * 2 * sizeof(float);
+	}
+	if (rasterizer) {
+		size += sizeof(NSVGrasterizer) +
+			rasterizer->cedges * sizeof(NSVGedge) +
+			(rasterizer->cpoints + rasterizer->cpoints2) * sizeof(NSVGpoint) +
+			rasterizer->cscanline;
+		for (const NSVGmemPage *page = rasterizer->pages; page; page = page->next) {
+			size += sizeof(NSVGmemPage);
+		}
+	}
+	memory::update(memory::MEMORY_PARSER, accountedBytes, size);
+}
+
 uint32_t makeColor(float r, float g, float b, float a) {
 	return nsvg__RGBA(
 		clamp(r, 0, 1) * 255.0,
@@ -414,12 +435,14 @@ NSVGimage *parsePath(const char *d) {
 	}
 	memset(parser->image, 0, sizeof(NSVGimage));
 
+	accountParserMemory();
 	return image;
 }
 
 float *pathArcTo(float *cpx, float *cpy, float *args, int &npts) {
 	NSVGparser *parser = getNSVGparser();
 	nsvg__pathArcTo(parser, cpx, cpy, args, 0);
+	accountParserMemory();
 	npts = parser->npts;
 	return parser->pts;
 }
@@ -453,6 +476,7 @@ bool shapeStrokeBounds(float *bounds, const NSVGshape *shape,
 	NSVGrasterizer *rasterizer = getRasterizer(quality);
 	nsvg__flattenShapeStroke(
 		rasterizer, const_cast<NSVGshape*>(shape), scale);
+	accountParserMemory();
 
 	const int n = rasterizer->nedges;
 	if (n < 1) {
@@ -499,6 +523,7 @@ void rasterize(NSVGimage *image, float tx, float ty, float scale,
 
 	nsvgRasterize(rasterizer, image, tx, ty, scale,
 			pixels, width, height, stride);
+	accountParserMemory();
 }
 
 Transform::Transform() {
@@ -570,10 +595,35 @@ void Transform::transformPoints(float *pts, const float *srcpts, int npts) const
 	}
 }
 
+Transform Transform::inverse() const {
+	Transform t;
+	if (!identity) {
+		nsvg__xformInverse(t.matrix, const_cast<float*>(&matrix[0]));
+		t.identity = false;
+	}
+	return t;
+}
+
 float Transform::getScale() const {
-	float x = matrix[0] + matrix[2];
-	float y = matrix[1] + matrix[3];
-	return std::sqrt(x * x + y * y);
+	// for similarities this is exactly the scale factor, otherwise it's
+	// the geometric mean of the axis scales.
+	return std::sqrt(std::abs(matrix[0] * matrix[3] - matrix[1] * matrix[2]));
+}
+
+bool Transform::isSimilarity() const {
+	if (identity) {
+		return true;
+	}
+	const float eps = 1e-4f * (
+		std::abs(matrix[0]) + std::abs(matrix[1]) +
+		std::abs(matrix[2]) + std::abs(matrix[3]));
+	const bool rotation =
+		std::abs(matrix[0] - matrix[3]) <= eps &&
+		std::abs(matrix[1] + matrix[2]) <= eps;
+	const bool reflection =
+		std::abs(matrix[0] + matrix[3]) <= eps &&
+		std::abs(matrix[1] - matrix[2]) <= eps;
+	return (rotation || reflection) && getScale() > 0.0f;
 }
 
 NSVGlineJoin nsvgLineJoin(ToveLineJoin join) {
@@ -124,8 +124,19 @@ public:
 	void transformGradient(NSVGgradient* grad) const;
 	void transformPoints(float *pts, const float *srcpts, int npts) const;
 
+	inline void transformPoint(float &x, float &y) const {
+		const float tx = x * matrix[0] + y * matrix[2] + matrix[4];
+		y = x * matrix[1] + y * matrix[3] + matrix[5];
+		x = tx;
+	}
+
+	Transform inverse() const;
+
 	float getScale() const;
 
+	// true for rotations, reflections, uniform scales and translations.
+	bool isSimilarity() const;
+
 	inline bool isIdentity() const {
 		return identity;
 	}
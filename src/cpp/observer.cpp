@@ -0,0 +1,76 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#include "observer.h"
+
+BEGIN_TOVE_NAMESPACE
+
+thread_local int ObserverBatch::depth = 0;
+thread_local std::vector<Observable*> ObserverBatch::pending;
+thread_local bool ObserverBatch::rigid = false;
+
+void Observable::broadcastChange(ToveChangeFlags what) {
+	if (ObserverBatch::depth > 0) {
+		if (pendingChanges == 0) {
+			ObserverBatch::pending.push_back(this);
+			pendingRigid = ObserverBatch::rigid;
+		} else {
+			pendingRigid = pendingRigid && ObserverBatch::rigid;
+		}
+		pendingChanges |= what;
+	} else {
+		dispatch(what);
+	}
+}
+
+void Observable::cancelPending() {
+	std::vector<Observable*> &pending = ObserverBatch::pending;
+	for (Observable *&observable : pending) {
+		if (observable == this) {
+			observable = nullptr;
+		}
+	}
+	pendingChanges = 0;
+	pendingRigid = false;
+}
+
+void ObserverBatch::flush() {
+	// we keep the batch open during dispatch, so that changes cascading
+	// upwards (subpath -> path -> graphics) get coalesced as well; those
+	// are appended to "pending" and processed in the same loop.
+	depth++;
+	for (size_t i = 0; i < pending.size(); i++) {
+		Observable *observable = pending[i];
+		if (!observable) {
+			continue;
+		}
+		pending[i] = nullptr;
+		const ToveChangeFlags what = observable->pendingChanges;
+		observable->pendingChanges = 0;
+		if (what) {
+			// changes cascading from here are as rigid as this one.
+			RigidScope scope(observable->pendingRigid);
+			observable->dispatch(what);
+		}
+	}
+	pending.clear();
+	depth--;
+}
+
+void ObserverBatch::end() {
+	assert(depth > 0);
+	if (depth == 1 && !pending.empty()) {
+		flush();
+	}
+	depth--;
+}
+
+END_TOVE_NAMESPACE
@@ -13,7 +13,8 @@
 #define __TOVE_OBSERVER 1
 
 #include "common.h"
-#include <unordered_set>
+#include <vector>
+#include <algorithm>
 
 BEGIN_TOVE_NAMESPACE
 
@@ -28,8 +29,86 @@ public:
         Observable *observable, ToveChangeFlags what) = 0;
 };
 
+// almost all observables have one or two observers (a path and maybe a
+// feed), so we keep these inline and only spill to the heap beyond that.
+class ObserverList {
+	enum {
+		INLINE_SIZE = 2
+	};
+
+	Observer *inlineObservers[INLINE_SIZE];
+	std::vector<Observer*> moreObservers;
+	int inlineCount;
+
+public:
+	inline ObserverList() : inlineCount(0) {
+	}
+
+	inline int size() const {
+		return inlineCount + moreObservers.size();
+	}
+
+	inline Observer *operator[](int i) const {
+		return i < inlineCount ?
+			inlineObservers[i] : moreObservers[i - inlineCount];
+	}
+
+	inline bool contains(Observer *observer) const {
+		return std::find(inlineObservers, inlineObservers + inlineCount,
+			observer) != inlineObservers + inlineCount ||
+			std::find(moreObservers.begin(), moreObservers.end(),
+			observer) != moreObservers.end();
+	}
+
+	inline void add(Observer *observer) {
+		if (contains(observer)) {
+			return;
+		}
+		if (inlineCount < INLINE_SIZE) {
+			inlineObservers[inlineCount++] = observer;
+		} else {
+			moreObservers.push_back(observer);
+		}
+	}
+
+	inline void remove(Observer *observer) {
+		for (int i = 0; i < inlineCount; i++) {
+			if (inlineObservers[i] == observer) {
+				for (int j = i + 1; j < inlineCount; j++) {
+					inlineObservers[j - 1] = inlineObservers[j];
+				}
+				if (moreObservers.empty()) {
+					inlineCount--;
+				} else {
+					inlineObservers[inlineCount - 1] = moreObservers.front();
+					moreObservers.erase(moreObservers.begin());
+				}
+				return;
+			}
+		}
+		const auto it = std::find(
+			moreObservers.begin(), moreObservers.end(), observer);
+		if (it != moreObservers.end()) {
+			moreObservers.erase(it);
+		}
+	}
+};
+
 class Observable {
-	std::unordered_set<Observer*> observers;
+	friend class ObserverBatch;
+
+	ObserverList observers;
+	ToveChangeFlags pendingChanges;
+	bool pendingRigid; // all pending changes came from rigid transforms
+
+	void dispatch(ToveChangeFlags what) {
+		const int n = observers.size();
+		for (int i = 0; i < n; i++) {
+			observers[i]->observableChanged(this, what);
+		}
+	}
+
+	void cancelPending();
 
 protected:
     inline bool hasObservers() const {
@@ -37,22 +116,79 @@ protected:
     }
 
 public:
+	inline Observable() : pendingChanges(0), pendingRigid(false) {
+	}
+
     virtual ~Observable() {
         assert(!hasObservers());
+		if (pendingChanges) {
+			cancelPending();
+		}
     }
 
 	inline void addObserver(Observer *observer) {
-        observers.insert(observer);        
+        observers.add(observer);
     }
 	inline void removeObserver(Observer *observer) {
-        observers.erase(observer);
+        observers.remove(observer);
     }
 
-	void broadcastChange(ToveChangeFlags what) {
-        for (Observer *observer : observers) {
-            observer->observableChanged(this, what);
-        }        
-    }
+	void broadcastChange(ToveChangeFlags what);
+};
+
+// while an ObserverBatch is alive, broadcasts are not dispatched but
+// collected, with flags being or-ed per observable. when the outermost
+// batch ends, each observable notifies its observers exactly once.
+
+// batches are per thread, observables must not be changed from other
+// threads while they have pending changes.
+class ObserverBatch {
+	friend class Observable;
+
+	static thread_local int depth;
+	static thread_local std::vector<Observable*> pending;
+	static thread_local bool rigid;
+
+	static void flush();
+
+public:
+	// marks changes broadcast during its lifetime as coming from rigid
+	// transforms. this sticks with pending changes until they dispatch.
+	class RigidScope {
+		const bool previous;
+
+	public:
+		inline RigidScope(bool isRigid) : previous(rigid) {
+			rigid = isRigid;
+		}
+
+		inline ~RigidScope() {
+			rigid = previous;
+		}
+	};
+
+	// true while dispatching changes that came from rigid transforms.
+	static inline bool dispatchingRigid() {
+		return rigid;
+	}
+
+	inline ObserverBatch() {
+		begin();
+	}
+
+	inline ~ObserverBatch() {
+		end();
+	}
+
+	static inline void begin() {
+		depth++;
+	}
+
+	static void end();
+
+	static inline bool active() {
+		return depth > 0;
+	}
 };
 
 END_TOVE_NAMESPACE
@@ -0,0 +1,124 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#include "packed.h"
+#include "path.h"
+#include "subpath.h"
+#include <algorithm>
+
+BEGIN_TOVE_NAMESPACE
+
+PackedPoints::PackedPoints(const std::vector<PathRef> &paths) : size(0) {
+	counts.reserve(paths.size());
+	for (const PathRef &path : paths) {
+		const auto &pathSubpaths = path->getSubpaths();
+		counts.push_back(pathSubpaths.size());
+		for (const SubpathRef &subpath : pathSubpaths) {
+			subpaths.push_back(subpath);
+			offsets.push_back(size);
+			size += subpath->nsvg.npts * 2;
+		}
+	}
+	offsets.push_back(size);
+
+	pts = static_cast<float*>(malloc(std::max(size, 1) * sizeof(float)));
+	if (!pts) {
+		TOVE_BAD_ALLOC();
+	}
+	buffer = std::shared_ptr<float>(pts, free);
+
+	const int n = subpaths.size();
+	for (int i = 0; i < n; i++) {
+		subpaths[i]->packPoints(buffer, pts + offsets[i]);
+	}
+}
+
+void PackedPoints::unpack() {
+	const int n = subpaths.size();
+	for (int i = 0; i < n; i++) {
+		const SubpathRef &subpath = subpaths[i];
+		if (subpath->isPackedAt(pts + offsets[i])) {
+			subpath->unpackPoints();
+		}
+	}
+}
+
+bool PackedPoints::isValid(const std::vector<PathRef> &paths) const {
+	if (paths.size() != counts.size()) {
+		return false;
+	}
+	int k = 0;
+	const int numPaths = paths.size();
+	for (int i = 0; i < numPaths; i++) {
+		const auto &pathSubpaths = paths[i]->getSubpaths();
+		if (pathSubpaths.size() != counts[i]) {
+			return false;
+		}
+		for (const SubpathRef &subpath : pathSubpaths) {
+			if (subpath != subpaths[k] ||
+				!subpath->isPackedAt(pts + offsets[k]) ||
+				subpath->nsvg.npts * 2 != offsets[k + 1] - offsets[k]) {
+				return false;
+			}
+			k++;
+		}
+	}
+	return true;
+}
+
+bool PackedPoints::hasLayoutOf(const std::vector<PathRef> &paths) const {
+	if (paths.size() != counts.size()) {
+		return false;
+	}
+	int k = 0;
+	const int numPaths = paths.size();
+	for (int i = 0; i < numPaths; i++) {
+		const auto &pathSubpaths = paths[i]->getSubpaths();
+		if (pathSubpaths.size() != counts[i]) {
+			return false;
+		}
+		for (const SubpathRef &subpath : pathSubpaths) {
+			if (subpath->nsvg.npts * 2 != offsets[k + 1] - offsets[k]) {
+				return false;
+			}
+			k++;
+		}
+	}
+	return true;
+}
+
+void PackedPoints::animate(
+	const std::vector<PathRef> &a,
+	const std::vector<PathRef> &b,
+	float t) {
+
+	assert(hasLayoutOf(a) && hasLayoutOf(b));
+	float *p = pts;
+	int k = 0;
+	const int numPaths = a.size();
+	for (int i = 0; i < numPaths; i++) {
+		const auto &subpathsA = a[i]->getSubpaths();
+		const auto &subpathsB = b[i]->getSubpaths();
+		const int numSubpaths = subpathsA.size();
+		for (int j = 0; j < numSubpaths; j++) {
+			const float * const p0 = subpathsA[j]->nsvg.pts;
+			const float * const p1 = subpathsB[j]->nsvg.pts;
+			const int n = offsets[k + 1] - offsets[k];
+			for (int l = 0; l < n; l++) {
+				p[l] = p0[l] + (p1[l] - p0[l]) * t;
+			}
+			p += n;
+			k++;
+		}
+	}
+}
+
+END_TOVE_NAMESPACE
@@ -0,0 +1,60 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_PACKED
+#define __TOVE_PACKED 1
+
+#include "common.h"
+#include <vector>
+#include <memory>
+
+BEGIN_TOVE_NAMESPACE
+
+// keeps the points of all subpaths of a Graphics in one contiguous
+// buffer, so that animating into it between two Graphics with the same
+// layout becomes one lerp per subpath into a single buffer. the source
+// Graphics don't get packed themselves.
+
+// subpaths that get structurally edited (e.g. by adding points) move
+// their points out of the buffer again; isValid() detects this. packed
+// subpaths share ownership of the buffer, so that it outlives us if
+// they do and nothing needs to get unpacked on destruction.
+
+class PackedPoints {
+	std::shared_ptr<float> buffer;
+	float *pts;
+	int size; // number of floats
+
+	std::vector<SubpathRef> subpaths;
+	std::vector<int> offsets; // per subpath, plus total size at end
+	std::vector<int> counts; // number of subpaths per path
+
+public:
+	PackedPoints(const std::vector<PathRef> &paths);
+
+	// moves the points of all subpaths still in our buffer back into
+	// their own storage. might throw std::bad_alloc.
+	void unpack();
+
+	bool isValid(const std::vector<PathRef> &paths) const;
+
+	// true if paths have as many subpaths and points as we pack.
+	bool hasLayoutOf(const std::vector<PathRef> &paths) const;
+
+	void animate(
+		const std::vector<PathRef> &a,
+		const std::vector<PathRef> &b,
+		float t);
+};
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_PACKED
@@ -120,13 +120,16 @@ NSVGgradient *AbstractGradient::getInverseNSVGgradient() {
 		TOVE_BAD_ALLOC();
 		return nullptr;
 	}
+	memory::update(memory::MEMORY_GRADIENTS, nsvgInverseBytes, size);
 	std::memcpy(nsvgInverse, nsvg, size);
 	xformInverse.store(nsvgInverse->xform);
 	return nsvgInverse;
 }
 
 AbstractGradient::AbstractGradient(int nstops) :
-	nsvgInverse(nullptr) {
+	nsvgInverse(nullptr),
+	nsvgBytes(0),
+	nsvgInverseBytes(0) {
 
 	const size_t size = getRecordSize(nstops);
 	nsvg = static_cast<NSVGgradient*>(malloc(size));
@@ -134,6 +137,7 @@ AbstractGradient::AbstractGradient(int nstops) :
 		TOVE_BAD_ALLOC();
 		return;
 	}
+	memory::update(memory::MEMORY_GRADIENTS, nsvgBytes, size);
 	nsvg->nstops = nstops;
 
 	nsvg::xformIdentity(nsvg->xform);
@@ -145,7 +149,9 @@ AbstractGradient::AbstractGradient(int nstops) :
 }
 
 AbstractGradient::AbstractGradient(const NSVGgradient *gradient) :
-	nsvgInverse(nullptr) {
+	nsvgInverse(nullptr),
+	nsvgBytes(0),
+	nsvgInverseBytes(0) {
 
 	const size_t size = getRecordSize(gradient->nstops);
 	nsvg = static_cast<NSVGgradient*>(malloc(size));
@@ -153,6 +159,7 @@ AbstractGradient::AbstractGradient(const NSVGgradient *gradient) :
 		TOVE_BAD_ALLOC();
 		return;
 	}
+	memory::update(memory::MEMORY_GRADIENTS, nsvgBytes, size);
 	std::memcpy(nsvg, gradient, size);
 
 	xformInverse.load(gradient->xform);
@@ -162,7 +169,9 @@ AbstractGradient::AbstractGradient(const NSVGgradient *gradient) :
 }
 
 AbstractGradient::AbstractGradient(const AbstractGradient &gradient) :
-	nsvgInverse(nullptr) {
+	nsvgInverse(nullptr),
+	nsvgBytes(0),
+	nsvgInverseBytes(0) {
 
 	const size_t size = getRecordSize(gradient.nsvg->nstops);
 	nsvg = static_cast<NSVGgradient*>(malloc(size));
@@ -170,6 +179,7 @@ AbstractGradient::AbstractGradient(const AbstractGradient &gradient) :
 		TOVE_BAD_ALLOC();
 		return;
 	}
+	memory::update(memory::MEMORY_GRADIENTS, nsvgBytes, size);
 	std::memcpy(nsvg, gradient.nsvg, size);
 	xformInverse = gradient.xformInverse;
 	sorted = gradient.sorted;
@@ -191,6 +201,7 @@ void AbstractGradient::set(const AbstractGradient *source) {
 		TOVE_BAD_ALLOC();
 		return;
 	}
+	memory::update(memory::MEMORY_GRADIENTS, nsvgBytes, nextpow2(size));
 	std::memcpy(nsvg, source->nsvg, size);
 	sorted = source->sorted;
 	xformInverse = source->xformInverse;
@@ -221,6 +232,7 @@ void AbstractGradient::setNumColorStops(int numStops) {
 	if (!nsvg) {
 		throw std::bad_alloc();
 	}
+	memory::update(memory::MEMORY_GRADIENTS, nsvgBytes, nextpow2(size));
 	nsvg->nstops = numStops;
 }
 
@@ -15,6 +15,7 @@
 #include "common.h"
 #include "observer.h"
 #include "nsvg.h"
+#include "accounting.h"
 
 BEGIN_TOVE_NAMESPACE
 
@@ -178,6 +179,10 @@ protected:
 	NSVGgradient *nsvgInverse;
 	nsvg::Matrix3x2 xformInverse;
 
+	// bytes accounted for nsvg and nsvgInverse (see accounting.h).
+	size_t nsvgBytes;
+	size_t nsvgInverseBytes;
+
 	static inline size_t getRecordSize(int nstops) {
 		return sizeof(NSVGgradient) + (nstops - 1) * sizeof(NSVGgradientStop);
 	}
@@ -206,6 +211,8 @@ public:
 		if (nsvgInverse) {
 			free(nsvgInverse);
 		}
+		memory::update(memory::MEMORY_GRADIENTS, nsvgBytes, 0);
+		memory::update(memory::MEMORY_GRADIENTS, nsvgInverseBytes, 0);
 	}
 
 	virtual void transform(const nsvg::Transform &transform);
@@ -364,6 +364,19 @@ const float *Path::getExactBounds() {
 	return exactBounds;
 }
 
+bool Path::intersects(const ToveBounds &view) {
+	const float *bounds = getBounds();
+
+	float margin = 0.0f;
+	if (hasStroke()) {
+		// miter joins reach out up to miterLimit * lineWidth / 2.
+		margin = getLineWidth() * 0.5f * std::max(1.0f, getMiterLimit());
+	}
+
+	return bounds[0] - margin <= view.x1 && bounds[2] + margin >= view.x0 &&
+		bounds[1] - margin <= view.y1 && bounds[3] + margin >= view.y0;
+}
+
 void Path::addSubpath(const SubpathRef &t) {
 	closeSubpath();
 	_append(t);
@@ -434,7 +447,8 @@ void Path::setLineDash(const float *dashes, const int count) {
 void Path::setLineDashOffset(float offset) {
 	if (offset != nsvg.strokeDashOffset) {
 		nsvg.strokeDashOffset = offset;
-		geometryChanged();
+		// dashes move along the line, the mesh can be updated in place.
+		changed(CHANGED_POINTS);
 	}
 }
 
@@ -674,6 +688,19 @@ void Path::animate(const PathRef &a, const PathRef &b, float t, int pathIndex) {
 			}
 		}
 	}
+	animateStyle(a, b, t, pathIndex);
+}
+
+void Path::animatePacked(const PathRef &a, const PathRef &b, float t, int pathIndex) {
+	const int n = subpaths.size();
+	for (int i = 0; i < n; i++) {
+		subpaths[i]->animatePacked(a->subpaths[i], b->subpaths[i], t);
+	}
+	changed(CHANGED_POINTS);
+	animateStyle(a, b, t, pathIndex);
+}
+
+void Path::animateStyle(const PathRef &a, const PathRef &b, float t, int pathIndex) {
 	if (a->fillColor && b->fillColor) {
 		if (!fillColor) {
 			setFillColor(a->fillColor->clone());
@@ -47,6 +47,7 @@ private:
 	void set(const NSVGshape *shape);
 
 	void animateLineDash(const PathRef &a, const PathRef &b, float t, int pathIndex);
+	void animateStyle(const PathRef &a, const PathRef &b, float t, int pathIndex);
 
 public:
 	NSVGshape nsvg;
@@ -73,6 +74,10 @@ public:
 	const float *getBounds();
 	const float *getExactBounds();
 
+	// conservative test whether the area covered by this path,
+	// including its stroke, overlaps the given rectangle.
+	bool intersects(const ToveBounds &view);
+
 	void addSubpath(const SubpathRef &t);
 	void removeSubpath(const SubpathRef &t);
 
@@ -115,6 +120,10 @@ public:
 		return nsvg.opacity >= 1.0f && lineColor && lineColor->isOpaque();
 	}
 
+	inline bool hasOpaqueFill() const {
+		return nsvg.opacity >= 1.0f && fillColor && fillColor->isOpaque();
+	}
+
 	void setOpacity(float opacity);
 
 	void set(const PathRef &path, const nsvg::Transform &transform);
@@ -127,6 +136,10 @@ public:
 		return subpaths.at(i);
 	}
 
+	inline const std::vector<SubpathRef> &getSubpaths() const {
+		return subpaths;
+	}
+
 	int getNumCurves() const;
 
 	inline float getLineWidth() const {
@@ -149,6 +162,7 @@ public:
 	void setFillRule(ToveFillRule rule);
 
 	void animate(const PathRef &a, const PathRef &b, float t, int pathIndex);
+	void animatePacked(const PathRef &a, const PathRef &b, float t, int pathIndex);
 	void refine(int factor);
 	void rotate(ToveElementType what, int k);
 	static bool morphify(const std::vector<PathRef> &paths);
@@ -32,5 +32,9 @@ References<AbstractMesh, ToveMeshRef> meshes;
 References<AbstractTesselator, ToveTesselatorRef> tesselators;
 References<Palette, TovePaletteRef> palettes;
 References<std::string, ToveNameRef> names;
+References<Timeline, ToveTimelineRef> timelines;
+References<MorphPlan, ToveMorphPlanRef> morphPlans;
+References<InstanceSet, ToveInstanceSetRef> instanceSets;
+References<MeshBatch, ToveMeshBatchRef> meshBatches;
 
 END_TOVE_NAMESPACE
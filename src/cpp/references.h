@@ -95,6 +95,22 @@ inline const NameRef &deref(const ToveNameRef &ref) {
 	return _deref<NameRef>(ref);
 }
 
+inline const TimelineRef &deref(const ToveTimelineRef &ref) {
+	return _deref<TimelineRef>(ref);
+}
+
+inline const MorphPlanRef &deref(const ToveMorphPlanRef &ref) {
+	return _deref<MorphPlanRef>(ref);
+}
+
+inline const InstanceSetRef &deref(const ToveInstanceSetRef &ref) {
+	return _deref<InstanceSetRef>(ref);
+}
+
+inline const MeshBatchRef &deref(const ToveMeshBatchRef &ref) {
+	return _deref<MeshBatchRef>(ref);
+}
+
 extern References<Graphics, ToveGraphicsRef> shapes;
 extern References<Path, TovePathRef> paths;
 extern References<Subpath, ToveSubpathRef> trajectories;
@@ -104,6 +120,10 @@ extern References<AbstractMesh, ToveMeshRef> meshes;
 extern References<AbstractTesselator, ToveTesselatorRef> tesselators;
 extern References<Palette, TovePaletteRef> palettes;
 extern References<std::string, ToveNameRef> names;
+extern References<Timeline, ToveTimelineRef> timelines;
+extern References<MorphPlan, ToveMorphPlanRef> morphPlans;
+extern References<InstanceSet, ToveInstanceSetRef> instanceSets;
+extern References<MeshBatch, ToveMeshBatchRef> meshBatches;
 
 #endif // TOVE_TARGET_LOVE2D
 
@@ -286,6 +286,45 @@ vec4 do_color(vec2 _1) {
 	return w.getSourcePtr();
 }
 
+const char *GetInstanceShaderCode() {
+	tove::ShaderWriter w;
+
+	// draws a flat (ColorMesh) Graphics once per instance. the per instance
+	// attributes follow the layout of ToveInstance.
+
+	w << R"GLSL(
+varying vec4 instance_tint;
+)GLSL";
+
+#if TOVE_TARGET == TOVE_TARGET_LOVE2D
+	w << R"GLSL(
+#ifdef VERTEX
+attribute vec4 InstanceMatrix;
+attribute vec2 InstanceTranslation;
+attribute vec4 InstanceTint;
+
+uniform vec3 mesh_transform;
+
+vec4 position(mat4 transform_projection, vec4 vertex_pos) {
+	vec2 p = mesh_transform.xy + mesh_transform.z * vertex_pos.xy;
+	p = vec2(dot(InstanceMatrix.xz, p), dot(InstanceMatrix.yw, p)) +
+		InstanceTranslation;
+	instance_tint = InstanceTint;
+	return transform_projection * vec4(p, vertex_pos.zw);
+}
+#endif // VERTEX
+
+#ifdef PIXEL
+vec4 effect(vec4 color, Image _2, vec2 _3, vec2 _4) {
+	return color * instance_tint;
+}
+#endif // PIXEL
+)GLSL";
+#endif
+
+	return w.getSourcePtr();
+}
+
 ToveShaderCode GetGPUXFillShaderCode(
 	const ToveShaderData *data,
 	bool fragLine,
@@ -25,6 +25,7 @@ float *Subpath::addPoints(int n, bool allowClosedEdit) {
 	if (!allowClosedEdit && isClosed()) {
 		tove::report::warn("editing closed trajectory.");
 	}
+	unpackPoints();
 	const int cpts = nextpow2(nsvg.npts + n);
 	nsvg.pts = static_cast<float*>(
 		realloc(nsvg.pts, cpts * 2 * sizeof(float)));
@@ -890,41 +891,58 @@ void Subpath::rotate(ToveElementType what, int k) {
 	}
 }
 
+inline float blossom(const float *p, float a, float b, float c) {
+	// polar form of the cubic bezier p[0], p[2], p[4], p[6].
+	const float q0 = p[0] + (p[2] - p[0]) * a;
+	const float q1 = p[2] + (p[4] - p[2]) * a;
+	const float q2 = p[4] + (p[6] - p[4]) * a;
+	const float r0 = q0 + (q1 - q0) * b;
+	const float r1 = q1 + (q2 - q1) * b;
+	return r0 + (r1 - r0) * c;
+}
+
 void Subpath::refine(const int factor) {
 	if (factor < 2) {
 		return;
 	}
 	const int n = getNumCurves(false);
-	for (int j = n - 1; j >= 0; j--) {
-		for (int i = factor; i > 1; i--) {
-			const float dt = 1.0f / i;
-			insertCurveAt(j + 1 - dt);
-		}
+	if (n < 1) {
+		return;
 	}
-}
 
-int gcd(int m, int n) {
-	while(m) {
-		const int t = m;
-		m = n % m;
-		n = t;
-	}
-	return n;
-}
- 
-inline int lcm(int m, int n) {
-	return m / gcd(m, n) * n;
-}
- 
-int lcm(const std::vector<int> &n) {
-	if (n.size() < 2) {
-		return 0;
+	// splits each curve into "factor" curves of equal parameter length
+	// in one pass (equivalent to repeated insertCurveAt, but linear).
+	const int npts0 = nsvg.npts;
+	const std::vector<float> src(nsvg.pts, nsvg.pts + 2 * npts0);
+	const int trailing = npts0 - (3 * n + 1);
+
+	setNumPoints(3 * n * factor + 1 + trailing);
+	float *pts = nsvg.pts;
+
+	const float df = 1.0f / factor;
+	for (int j = 0; j < n; j++) {
+		for (int dim = 0; dim < 2; dim++) {
+			const float *p = &src[2 * 3 * j + dim];
+			float *q = &pts[2 * 3 * j * factor + dim];
+			for (int k = 0; k < factor; k++) {
+				const float t0 = k * df;
+				const float t1 = (k + 1) * df;
+				q[0] = blossom(p, t0, t0, t0);
+				q[2] = blossom(p, t0, t0, t1);
+				q[4] = blossom(p, t0, t1, t1);
+				q += 6;
+			}
+		}
 	}
-	int x = n[0];
-	for (int i = 1; i < n.size(); i++) {
-		x = lcm(x, n[i]);
+
+	for (int dim = 0; dim < 2; dim++) {
+		pts[2 * 3 * n * factor + dim] = src[2 * 3 * n + dim];
 	}
-	return x;
+	std::memcpy(&pts[2 * (3 * n * factor + 1)], &src[2 * (3 * n + 1)],
+		2 * trailing * sizeof(float));
+
+	fixLoop();
+	changed(CHANGED_GEOMETRY);
 }
 
 bool Subpath::morphify(const std::vector<SubpathRef> &subpaths) {
@@ -1313,6 +1331,36 @@ bool Subpath::animate(const SubpathRef &a, const SubpathRef &b, float t) {
 	return true;
 }
 
+void Subpath::animatePacked(const SubpathRef &a, const SubpathRef &b, float t) {
+	// points have already been interpolated by PackedPoints::animate.
+	commands.clear();
+	nsvg.closed = t < 0.5 ? a->nsvg.closed : b->nsvg.closed;
+	dirty |= DIRTY_BOUNDS | DIRTY_COEFFICIENTS | DIRTY_CURVE_BOUNDS;
+}
+
+void Subpath::packPoints(const std::shared_ptr<float> &buffer, float *pts) {
+	std::memcpy(pts, nsvg.pts, nsvg.npts * 2 * sizeof(float));
+	if (!packedBuffer) {
+		free(nsvg.pts);
+	}
+	nsvg.pts = pts;
+	packedBuffer = buffer;
+}
+
+void Subpath::unpackPoints() {
+	if (!packedBuffer) {
+		return;
+	}
+	const size_t size = nextpow2(nsvg.npts) * 2 * sizeof(float);
+	float *pts = static_cast<float*>(malloc(size));
+	if (!pts) {
+		throw std::bad_alloc();
+	}
+	std::memcpy(pts, nsvg.pts, nsvg.npts * 2 * sizeof(float));
+	nsvg.pts = pts;
+	packedBuffer.reset();
+}
+
 void Subpath::updateNSVG() {
 	// NanoSVG will crash if we give it incomplete curves. so we duplicate points
 	// to make complete curves here.
@@ -1350,8 +1398,11 @@ void Subpath::invert() {
 		pts[i * 2 + 0] = nsvg.pts[j * 2 + 0];
 		pts[i * 2 + 1] = nsvg.pts[j * 2 + 1];
 	}
-	free(nsvg.pts);
+	if (!packedBuffer) {
+		free(nsvg.pts);
+	}
 	nsvg.pts = pts;
+	packedBuffer.reset();
 
 	for (int i = 0; i < commands.size(); i++) {
 		commands[i].index = n - 1 - commands[i].index;
@@ -1681,50 +1732,124 @@ ToveNearest Subpath::nearest(
 }
 
 
-bool SubpathCleaner::reduce(float eps, bool addVanishing) {
-	pts[n] = pts[0];
-	indices[n] = indices[0];
+inline static bool vanishes(
+	const vec2 &a, const vec2 &b, const vec2 &c, float eps) {
 
-	pts[n + 1] = pts[1];
-	indices[n + 1] = indices[1];
+	// same area as in computeFromAreas. NaNs vanish as well.
+	const float area = (a.x - b.x) * (c.y - b.y) - (a.y - b.y) * (c.x - b.x);
+	return !(std::abs(area) > eps);
+}
 
-	const NonVanishingAreas nv(good.data(), eps);
-	computeFromAreas(pts.data(), n, nv);
+int SubpathCleaner::clean(float eps, bool addVanishing) {
+	// works in passes. in each pass, a vanishing triangle (a, b, c)
+	// removes b, unless a got removed in the same pass. as opposed to
+	// checking all triangles in each pass, we only check those that
+	// changed since the last pass, i.e. those next to removed points.
+	// triangles that did not vanish before do not vanish now. thus,
+	// the work done is linear in the number of points and removals.
 
-	int j = 0;
-	int skip = 0;
+	if (n < 1) {
+		return 0;
+	}
 
-	for (int i = 0; i < n; i++) {
-		if (skip > 0) {
-			skip -= 1;
+	// most subpaths have nothing to remove. otherwise, the first pass
+	// starts at the first vanishing triangle.
+	int32_t first = 0;
+	while (first + 2 < n &&
+		!vanishes(pts[first], pts[first + 1], pts[first + 2], eps)) {
+		first++;
+	}
+	while (first < n && !vanishes(
+		pts[first], pts[(first + 1) % n], pts[(first + 2) % n], eps)) {
+		first++;
+	}
+	if (first == n) {
+		return n;
+	}
 
-			continue;
-		} else if (!good[i]) {
-			skip = 1;
+	for (int32_t i = 0; i < n; i++) {
+		next[i] = i + 1;
+		prev[i] = i - 1;
+	}
+	next[n - 1] = 0;
+	prev[0] = n - 1;
+
+	const int32_t head = 0;
+	int32_t size = n;
+
+	changed.clear();
+	for (int32_t i = first; i < n; i++) {
+		changed.push_back(i);
+	}
+
+	while (!changed.empty()) {
+		// the first point stays, unless it is the only one. a vanishing
+		// triangle that wraps around removes the last point instead and
+		// sees the second point as it was at the start of the pass.
+		const int32_t tail = prev[head];
+		const int32_t second = next[head];
+		int32_t skip = -1;
 
+		removedInPass.clear();
+		for (const int32_t a : changed) {
+			if (a == skip) {
+				continue;
+			}
+			const int32_t b = next[a];
+			const int32_t c = a == tail ? second : next[b];
+			if (!vanishes(pts[a], pts[b], pts[c], eps)) {
+				continue;
+			}
 			if (addVanishing) {
-				vanishing.add(
-					indices[i + 0],
-					indices[i + 1],
-					indices[i + 2]);
+				vanishing.add(indices[a], indices[b], indices[c]);
+			}
+			if (a == tail) {
+				removePoint(a);
+			} else {
+				removePoint(b);
+				skip = b;
 			}
+		}
 
-			if (i == n - 1) {
-				continue;
+		size -= removedInPass.size();
+		if (size < 1) {
+			n = 0;
+			return 0;
+		}
+
+		// triangles starting at the two points before each removed one.
+		// these come in order, except for the triangle wrapping around.
+		changed.clear();
+		bool wraps = false;
+		for (int32_t i : removedInPass) {
+			// a point is removed iff its predecessor skips it.
+			do {
+				i = prev[i];
+			} while (next[prev[i]] != i);
+			if (i == head) {
+				wraps = true;
+			} else if (changed.empty() || prev[i] > changed.back()) {
+				changed.push_back(prev[i]);
 			}
+			if (changed.empty() || i > changed.back()) {
+				changed.push_back(i);
+			}
+		}
+		const int32_t last = prev[head];
+		if (wraps && (changed.empty() || last > changed.back())) {
+			changed.push_back(last);
 		}
+	}
 
+	int32_t i = head;
+	for (int32_t j = 0; j < size; j++) {
 		pts[j] = pts[i];
 		indices[j] = indices[i];
-		j++;
+		i = next[i];
 	}
+	n = size;
 
-	if (j < n) {
-		n = j;
-		return true;
-	} else {
-		return false;
-	}
+	return n;
 }
 
 END_TOVE_NAMESPACE
@@ -20,6 +20,7 @@
 #include "utils.h"
 #include "intersect.h"
 #include "mesh/area.h"
+#include "accounting.h"
 
 BEGIN_TOVE_NAMESPACE
 
@@ -49,6 +50,8 @@ private:
     mutable std::vector<CurveData> curves;
 	std::vector<ToveCurvature> curvature;
 	mutable uint8_t dirty;
+	// keeps the PackedPoints buffer alive while nsvg.pts points into it.
+	std::shared_ptr<float> packedBuffer;
 
 	float *addPoints(int n, bool allowClosedEdit = false);
 
@@ -90,7 +93,9 @@ public:
 	Subpath(const SubpathRef &t);
 
 	inline ~Subpath() {
-		free(nsvg.pts);
+		if (!packedBuffer) {
+			free(nsvg.pts);
+		}
 	}
 
     inline void commit() const {
@@ -228,6 +233,14 @@ public:
 		ExCurveData &extended);
 
 	bool animate(const SubpathRef &a, const SubpathRef &b, float t);
+	void animatePacked(const SubpathRef &a, const SubpathRef &b, float t);
+
+	void packPoints(const std::shared_ptr<float> &buffer, float *pts);
+	void unpackPoints();
+
+	inline bool isPackedAt(const float *pts) const {
+		return packedBuffer && nsvg.pts == pts;
+	}
 
 	inline void setNext(const SubpathRef &trajectory) {
 		nsvg.next = &trajectory->nsvg;
@@ -254,30 +267,60 @@ public:
 
 class SubpathCleaner {
 	std::vector<vec2> pts;
-	std::vector<uint8_t> good;
 	std::vector<ToveVertexIndex> indices;
 
+	// points not removed yet, as cyclic doubly linked list. removed
+	// points keep the links they had, which might be stale.
+	std::vector<int32_t> next;
+	std::vector<int32_t> prev;
+
+	// points whose triangle (i, next[i], next[next[i]]) changed in the
+	// last pass, in order, and points removed in the current pass.
+	std::vector<int32_t> changed;
+	std::vector<int32_t> removedInPass;
+
 	int n;
 	int allocated;
 
+	// bytes of our buffers (see accounting.h).
+	size_t byteSize;
+
 	VanishingTriangles vanishing;
 
-	static void computeGood(
-		const vec2 * const v,
-		uint8_t * const a,
-		const int n);
+	inline void removePoint(int32_t i) {
+		next[prev[i]] = next[i];
+		prev[next[i]] = prev[i];
+		removedInPass.push_back(i);
+	}
 
 public:
-	inline SubpathCleaner() : n(0), allocated(0) {
+	inline SubpathCleaner() : n(0), allocated(0), byteSize(0) {
+	}
+
+	SubpathCleaner(const SubpathCleaner&) = delete;
+
+	inline ~SubpathCleaner() {
+		memory::update(memory::MEMORY_CLEANERS, byteSize, 0);
 	}
 
 	inline void init(const int maxSize, const int numTotal = 0) {
 		if (maxSize > allocated) {
-			pts.resize(maxSize + 2);
-			indices.resize(maxSize + 2);
-			good.resize(maxSize);
+			pts.resize(maxSize);
+			indices.resize(maxSize);
+			next.resize(maxSize);
+			prev.resize(maxSize);
+
+			// each removal changes at most two triangles.
+			changed.reserve(maxSize + 2);
+			removedInPass.reserve(maxSize);
 
 			allocated = maxSize;
+
+			memory::update(memory::MEMORY_CLEANERS, byteSize,
+				pts.capacity() * sizeof(vec2) +
+				indices.capacity() * sizeof(ToveVertexIndex) +
+				(next.capacity() + prev.capacity()) * sizeof(int32_t) +
+				(changed.capacity() + removedInPass.capacity()) * sizeof(int32_t));
 		}
 
 		if (numTotal > 0) {
@@ -294,20 +337,20 @@ public:
 		return n;
 	}
 
+	inline size_t getByteSize() const {
+		return byteSize;
+	}
+
 	inline void add(float x, float y, ToveVertexIndex i) {
 		pts[n] = vec2(x, y);
 		indices[n] = i;
 		n++;
 	}
 
-	bool reduce(float eps, bool addVanishing);
-
-	inline int clean(float eps = 1e-2f, bool addVanishing = true) {
-		while (reduce(eps, addVanishing)) {
-			continue;
-		}
-		return n;
-	}
+	// removes points whose triangle with their neighbors has an area of
+	// at most eps, until no such points are left. removed triangles get
+	// added to our vanishing triangles. returns the new size.
+	int clean(float eps = 1e-2f, bool addVanishing = true);
 
 	inline const std::vector<vec2> &getPoints() const {
 		return pts;
@@ -0,0 +1,168 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#include "timeline.h"
+#include "graphics.h"
+#include <algorithm>
+
+BEGIN_TOVE_NAMESPACE
+
+Timeline::Timeline(ToveInterpolation interpolation) :
+	interpolation(interpolation) {
+}
+
+float Timeline::ease(ToveEasing easing, float t) {
+	switch (easing) {
+		case TOVE_EASE_LINEAR:
+			return t;
+		case TOVE_EASE_NONE:
+			return t < 1.0f ? 0.0f : 1.0f;
+		case TOVE_EASE_IN_QUAD:
+			return t * t;
+		case TOVE_EASE_OUT_QUAD:
+			return t * (2.0f - t);
+		case TOVE_EASE_IN_OUT_QUAD:
+			return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+		case TOVE_EASE_IN_CUBIC:
+			return t * t * t;
+		case TOVE_EASE_OUT_CUBIC: {
+			const float s = t - 1.0f;
+			return s * s * s + 1.0f;
+		}
+		case TOVE_EASE_IN_OUT_CUBIC: {
+			if (t < 0.5f) {
+				return 4.0f * t * t * t;
+			}
+			const float s = 2.0f * t - 2.0f;
+			return 0.5f * s * s * s + 1.0f;
+		}
+	}
+	return t;
+}
+
+void Timeline::addKey(const GraphicsRef &graphics, float time, ToveEasing ease) {
+	if (!keys.empty() && time < keys.back().time) {
+		tove::report::warn("timeline keys must be added in temporal order.");
+		time = keys.back().time;
+	}
+	keys.push_back(Key{graphics, time, ease});
+}
+
+bool Timeline::evaluate(float t, const GraphicsRef &target) const {
+	const int n = keys.size();
+	if (n < 1) {
+		return false;
+	}
+	if (n == 1) {
+		target->animate(keys[0].graphics, keys[0].graphics, 0.0f);
+		return true;
+	}
+
+	t = clamp(t, keys[0].time, keys[n - 1].time);
+
+	const auto it = std::lower_bound(keys.begin() + 1, keys.end() - 1, t,
+		[] (const Key &key, float t) {
+			return key.time < t;
+		});
+	const int k1 = it - keys.begin();
+	const int k0 = k1 - 1;
+
+	const Key &key0 = keys[k0];
+	const Key &key1 = keys[k1];
+
+	const float duration = key1.time - key0.time;
+	const float u = ease(key1.ease,
+		duration > 0.0f ? (t - key0.time) / duration : 1.0f);
+
+	// animate() takes care of everything that is not a point (colors,
+	// line widths, dashes, ...) and gives us linearly blended points.
+	target->animate(key0.graphics, key1.graphics, u);
+
+	if (interpolation == TOVE_INTERPOLATE_CATMULL_ROM &&
+		key1.ease != TOVE_EASE_NONE && n > 2) {
+
+		const GraphicsRef graphics[4] = {
+			keys[std::max(k0 - 1, 0)].graphics,
+			key0.graphics,
+			key1.graphics,
+			keys[std::min(k1 + 1, n - 1)].graphics
+		};
+		blendCatmullRom(target, graphics, u);
+	}
+
+	return true;
+}
+
+void Timeline::blendCatmullRom(
+	const GraphicsRef &target,
+	const GraphicsRef *graphics,
+	float t) const {
+
+	const float t2 = t * t;
+	const float t3 = t2 * t;
+
+	// uniform Catmull-Rom weights for p[-1], p[0], p[1], p[2].
+	const float w[4] = {
+		0.5f * (-t3 + 2.0f * t2 - t),
+		0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f),
+		0.5f * (-3.0f * t3 + 4.0f * t2 + t),
+		0.5f * (t3 - t2)
+	};
+
+	const int numPaths = target->getNumPaths();
+	for (int j = 0; j < 4; j++) {
+		if (graphics[j]->getNumPaths() != numPaths) {
+			return; // animate() already warned about this.
+		}
+	}
+
+	ObserverBatch batch;
+
+	for (int i = 0; i < numPaths; i++) {
+		const PathRef path = target->getPath(i);
+		const int numSubpaths = path->getNumSubpaths();
+
+		PathRef sources[4];
+		bool compatible = true;
+		for (int j = 0; j < 4; j++) {
+			sources[j] = graphics[j]->getPath(i);
+			compatible = compatible &&
+				sources[j]->getNumSubpaths() == numSubpaths;
+		}
+		if (!compatible) {
+			continue;
+		}
+
+		for (int k = 0; k < numSubpaths; k++) {
+			const SubpathRef &subpath = path->getSubpaths()[k];
+			const int npts = subpath->nsvg.npts;
+
+			const float *p[4];
+			for (int j = 0; j < 4; j++) {
+				const SubpathRef &source = sources[j]->getSubpaths()[k];
+				compatible = compatible && source->nsvg.npts == npts;
+				p[j] = source->nsvg.pts;
+			}
+			if (!compatible) {
+				break;
+			}
+
+			float * const pts = subpath->nsvg.pts;
+			for (int m = 0; m < npts * 2; m++) {
+				pts[m] = w[0] * p[0][m] + w[1] * p[1][m] +
+					w[2] * p[2][m] + w[3] * p[3][m];
+			}
+			subpath->changed(CHANGED_POINTS);
+		}
+	}
+}
+
+END_TOVE_NAMESPACE
@@ -0,0 +1,55 @@
+/*
+ * TÖVE - Animated vector graphics for LÖVE.
+ * https://github.com/poke1024/tove2d
+ *
+ * Copyright (c) 2018, Bernhard Liebl
+ *
+ * Distributed under the MIT license. See LICENSE file for details.
+ *
+ * All rights reserved.
+ */
+
+#ifndef __TOVE_TIMELINE
+#define __TOVE_TIMELINE 1
+
+#include "common.h"
+#include <vector>
+
+BEGIN_TOVE_NAMESPACE
+
+// a sequence of morph compatible Graphics at given times. evaluating
+// the timeline at some time blends the surrounding keys into a target
+// Graphics in one call.
+
+class Timeline {
+	struct Key {
+		GraphicsRef graphics;
+		float time;
+		ToveEasing ease; // easing from the previous key to this one
+	};
+
+	std::vector<Key> keys;
+	const ToveInterpolation interpolation;
+
+	static float ease(ToveEasing easing, float t);
+
+	void blendCatmullRom(
+		const GraphicsRef &target,
+		const GraphicsRef *graphics,
+		float t) const;
+
+public:
+	Timeline(ToveInterpolation interpolation);
+
+	void addKey(const GraphicsRef &graphics, float time, ToveEasing ease);
+
+	inline float getDuration() const {
+		return keys.empty() ? 0.0f : keys.back().time;
+	}
+
+	bool evaluate(float t, const GraphicsRef &target) const;
+};
+
+END_TOVE_NAMESPACE
+
+#endif // __TOVE_TIMELINE
@@ -14,6 +14,7 @@
 
 #include "common.h"
 #include <cmath>
+#include <vector>
 
 BEGIN_TOVE_NAMESPACE
 
@@ -73,6 +74,30 @@ inline int ncurves(int npts) {
 	return n;
 }
 
+inline int gcd(int m, int n) {
+	while(m) {
+		const int t = m;
+		m = n % m;
+		n = t;
+	}
+	return n;
+}
+
+inline int lcm(int m, int n) {
+	return m / gcd(m, n) * n;
+}
+
+inline int lcm(const std::vector<int> &n) {
+	if (n.size() < 2) {
+		return 0;
+	}
+	int x = n[0];
+	for (int i = 1; i < n.size(); i++) {
+		x = lcm(x, n[i]);
+	}
+	return x;
+}
+
 template<typename T>
 inline double dot4(const T *v, double x, double y, double z, double w) {
 	return v[0] * x + v[1] * y + v[2] * z + v[3] * w;
@@ -13,6 +13,52 @@ local function _linear(x)
 	return x
 end
 
+local _easings = {
+	linear = {lib.TOVE_EASE_LINEAR, _linear},
+	none = {lib.TOVE_EASE_NONE, function(x) return x < 1 and 0 or 1 end},
+	inQuad = {lib.TOVE_EASE_IN_QUAD, function(x) return x * x end},
+	outQuad = {lib.TOVE_EASE_OUT_QUAD, function(x) return x * (2 - x) end},
+	inOutQuad = {lib.TOVE_EASE_IN_OUT_QUAD, function(x)
+		return x < 0.5 and 2 * x * x or -1 + (4 - 2 * x) * x end},
+	inCubic = {lib.TOVE_EASE_IN_CUBIC, function(x) return x * x * x end},
+	outCubic = {lib.TOVE_EASE_OUT_CUBIC, function(x)
+		local s = x - 1
+		return s * s * s + 1 end},
+	inOutCubic = {lib.TOVE_EASE_IN_OUT_CUBIC, function(x)
+		if x < 0.5 then
+			return 4 * x * x * x
+		end
+		local s = 2 * x - 2
+		return 0.5 * s * s * s + 1 end}
+}
+
+local _interpolations = {
+	linear = lib.TOVE_INTERPOLATE_LINEAR,
+	["catmull-rom"] = lib.TOVE_INTERPOLATE_CATMULL_ROM
+}
+
+-- returns the native easing enum for ease, or nil if ease is a
+-- custom Lua function.
+local function nativeEase(ease)
+	if ease == _linear then
+		return lib.TOVE_EASE_LINEAR
+	elseif type(ease) == "string" then
+		local e = _easings[ease]
+		if e == nil then
+			error("unknown easing " .. ease)
+		end
+		return e[1]
+	end
+	return nil
+end
+
+local function luaEase(ease)
+	if type(ease) == "string" then
+		return _easings[ease][2]
+	end
+	return ease
+end
+
 -- Helpers for animating things.
 
 --- @module animation
@@ -29,12 +75,14 @@ Tween.__index = Tween
 -- @treturn Tween new empty tween
 
 tove.newTween = function(graphics)
-	return setmetatable({_graphics0 = graphics, _to = {}, _duration = 0, _morph = false}, Tween)
+	return setmetatable({_graphics0 = graphics, _to = {}, _duration = 0,
+		_morph = false, _interpolation = "linear"}, Tween)
 end
 
-tove.newMorph = function(graphics)
+tove.newMorph = function(graphics, plan)
 	local t = tove.newTween(graphics)
 	t._morph = true
+	t._plan = plan
 	return t
 end
 
@@ -43,7 +91,9 @@ end
 -- tween = tove.newTween(svg1):to(svg2, 0.3):to(svg3, 0.1)
 -- @tparam Graphics graphics @{Graphics} which will be at the new step
 -- @tparam number duration duration from current end of tween to step
--- @tparam[opt] function ease easing function
+-- @tparam[opt] function|string ease easing function, or one of `"linear"`, `"none"`,
+-- `"inQuad"`, `"outQuad"`, `"inOutQuad"`, `"inCubic"`, `"outCubic"` and `"inOutCubic"`.
+-- Named easings get evaluated natively in animations.
 -- @treturn Tween the modified tween
 
 function Tween:to(graphics, duration, ease)
@@ -52,13 +102,93 @@ function Tween:to(graphics, duration, ease)
 	return self
 end
 
-local function morphify(graphics)
+--- Set interpolation between steps.
+-- `"catmull-rom"` gives smooth motion through all steps of an animation
+-- instead of linear blends between pairs of steps. It needs all steps
+-- to use named easings (see @{Tween:to}).
+-- @tparam string mode either `"linear"` or `"catmull-rom"`
+-- @treturn Tween the modified tween
+
+function Tween:setInterpolation(mode)
+	if _interpolations[mode] == nil then
+		error("unknown interpolation " .. tostring(mode))
+	end
+	self._interpolation = mode
+	return self
+end
+
+local function graphicsRefs(graphics)
 	local n = #graphics
 	local refs = ffi.new("ToveGraphicsRef[?]", n)
 	for i, g in ipairs(graphics) do
 		refs[i - 1] = g._ref
 	end
-	lib.GraphicsMorphify(refs, n)
+	return refs, n
+end
+
+local function morphify(graphics)
+	lib.GraphicsMorphify(graphicsRefs(graphics))
+end
+
+--- A morph plan.
+-- Records how a set of @{Graphics} needs to be refined (and rotated) to
+-- become morph compatible, so that this can be reapplied to copies of
+-- these @{Graphics} without analyzing them again.
+-- @type MorphPlan
+-- @set sort=true
+
+local MorphPlan = {}
+MorphPlan.__index = MorphPlan
+
+--- Create new morph plan.
+-- @usage
+-- plan = tove.newMorphPlan({svg1, svg2})
+-- love.filesystem.write("morph.plan", plan:serialize())
+-- plan = tove.newMorphPlan(love.filesystem.read("morph.plan"))
+-- @tparam table|string graphics list of @{Graphics} to analyze, or a
+-- string obtained from @{MorphPlan:serialize}
+-- @treturn MorphPlan new morph plan, or nil if graphics are not compatible
+
+tove.newMorphPlan = function(graphics)
+	local ref
+	if type(graphics) == "string" then
+		ref = lib.NewMorphPlanFromString(graphics)
+	else
+		ref = lib.NewMorphPlan(graphicsRefs(graphics))
+	end
+	if ref.ptr == nil then
+		return nil
+	end
+	return setmetatable({_ref = ffi.gc(ref, lib.ReleaseMorphPlan)}, MorphPlan)
+end
+
+--- Apply to graphics.
+-- Makes the given @{Graphics} morph compatible. They need to have the
+-- same structure as the ones the plan was created from.
+-- @tparam table graphics list of @{Graphics}
+-- @treturn bool true if the plan could be applied
+
+function MorphPlan:apply(graphics)
+	return lib.MorphPlanApply(self._ref, graphicsRefs(graphics))
+end
+
+--- Rotate and record.
+-- Rotates elements of the i-th @{Graphics} and records this rotation
+-- in the plan, so that @{MorphPlan:apply} will repeat it.
+-- @tparam int i index of graphics in the list the plan was created from
+-- @tparam Graphics graphics the @{Graphics} to rotate now
+-- @tparam string what see @{Graphics:rotate}
+-- @tparam int k see @{Graphics:rotate}
+
+function MorphPlan:rotate(i, graphics, what, k)
+	return lib.MorphPlanRotate(self._ref, graphics._ref, i - 1, tove.elements[what], k)
+end
+
+--- Serialize.
+-- @treturn string a string that can be passed to @{tove.newMorphPlan}
+
+function MorphPlan:serialize()
+	return ffi.string(lib.MorphPlanSerialize(self._ref))
 end
 
 local function createGraphics(graphics)
@@ -101,6 +231,9 @@ tove.newFlipbook = function(fps, tween, ...)
 
 		local g1 = createGraphics(keyframe.graphics)
 		local ease = keyframe.ease
+		if ease ~= "none" then
+			ease = luaEase(ease)
+		end
 
 		-- for flipbooks, we can morph between pairs of
 		-- graphics (we don't need a global morph).
@@ -167,6 +300,7 @@ tove.newAnimation = function(tween, ...)
 	graphics:setUsage("points", "stream")
 	graphics:setUsage("colors", "stream")
 	graphics:setDisplay(unpack(display))
+	graphics:setPackedPoints(true)
 	local offset = 0
 
 	do
@@ -191,17 +325,45 @@ tove.newAnimation = function(tween, ...)
 		for i, f in ipairs(keyframes) do
 			table.insert(g, f.graphics)
 		end
-		morphify(g)
+		if tween._plan == nil or not tween._plan:apply(g) then
+			morphify(g)
+		end
+	end
+
+	-- if we know all easings natively, we let a native timeline
+	-- do the blending in one call.
+	local timeline = ffi.gc(lib.NewTimeline(
+		_interpolations[tween._interpolation]), lib.ReleaseTimeline)
+	for i, f in ipairs(keyframes) do
+		local ease = nativeEase(f.ease)
+		if ease == nil then
+			timeline = nil
+			break
+		end
+		lib.TimelineAddKey(timeline, f.graphics._ref, f.offset, ease)
+	end
+	if timeline == nil then
+		if tween._interpolation ~= "linear" then
+			tove.warn("interpolation " .. tween._interpolation ..
+				" needs named easings, falling back to linear.")
+		end
+		for i, f in ipairs(keyframes) do
+			f.ease = luaEase(f.ease)
+		end
 	end
 
 	return setmetatable({_keyframes = keyframes, _graphics = graphics,
-		_t = 0, _i = 1, _duration = tween._duration}, Animation)
+		_timeline = timeline, _t = 0, _i = 1, _duration = tween._duration}, Animation)
 end
 
 Animation.__newindex = function(self, key, value)
 	if key == "t" then
 		local t = math.max(0, math.min(value, self._duration))
 		self._t = t
+		if self._timeline ~= nil then
+			lib.TimelineEvaluate(self._timeline, t, self._graphics._ref)
+			return
+		end
 		local f = self._keyframes
 		local n = #f
 		if n > 1 then
@@ -249,3 +411,11 @@ end
 function Animation:setName(n)
 	self._graphics:setName(n)
 end
+
+function Animation:saveTriangulations()
+	return self._graphics:saveTriangulations()
+end
+
+function Animation:loadTriangulations(s)
+	return self._graphics:loadTriangulations(s)
+end
@@ -0,0 +1,207 @@
+-- *****************************************************************
+-- TÖVE - Animated vector graphics for LÖVE.
+-- https://github.com/poke1024/tove2d
+--
+-- Copyright (c) 2018, Bernhard Liebl
+--
+-- Distributed under the MIT license. See LICENSE file for details.
+--
+-- All rights reserved.
+-- *****************************************************************
+
+--- Many different @{Graphics} drawn in one call.
+-- @classmod Batch
+-- @set sort=true
+
+-- matches the vertex layout of color meshes.
+local _attributes = {
+	{"VertexPosition", "float", 2},
+	{"VertexColor", "byte", 4}}
+
+local vertexByteSize = 2 * ffi.sizeof("float") + 4
+
+-- changes that only move points.
+local _pointChanges = lib.CHANGED_POINTS + lib.CHANGED_BOUNDS + lib.CHANGED_EXACT_BOUNDS
+
+local Batch = {}
+Batch.__index = Batch
+
+--- Create new batch.
+-- Tesselates each member @{Graphics} into a flat mesh and merges all members, each
+-- with its own transform, into one mesh, so that a whole layer draws in one call.
+-- Changing a member's transform or points only copies that member's vertices.
+-- Non-solid paints get rendered as with @{Graphics:setUsage}`("shaders", "avoid")`.
+-- Members are drawn in the order they were added. As the batch keeps track of the
+-- changes of its members, do not draw members on their own.
+-- @usage
+-- layer = tove.newBatch()
+-- for i, tree in ipairs(trees) do
+--     layer:setTransform(layer:add(tree), i * 100, 300)
+-- end
+-- layer:draw()
+-- @tparam[opt="dynamic"] string usage usage of the merged mesh (see <a href="https://love2d.org/wiki/SpriteBatchUsage">love2d docs on mesh usage</a>)
+
+tove.newBatch = function(usage)
+	return setmetatable({
+		_ref = ffi.gc(lib.NewMeshBatch(), lib.ReleaseMeshBatch),
+		_members = {},
+		_usage = usage or "dynamic",
+		_mesh = nil,
+		_vdata = nil,
+		_idata = nil}, Batch)
+end
+
+local function tesselate(member, flags)
+	local graphics = member.graphics
+	local tess = member.tess
+	local viewScale, minPathSize = unpack(graphics._view or {0, 0})
+	lib.TesselatorSetViewScale(tess, viewScale, minPathSize)
+	lib.TesselatorSetOcclusionCulling(tess, graphics._occlusion or false)
+	lib.TesselatorSetAsyncTriangulation(tess, graphics._async or false)
+	return lib.TesselatorTessGraphics(
+		tess, graphics._ref, member.mesh, flags, nil)
+end
+
+--- Add a member.
+-- Uses the tesselator of the @{Graphics}' "mesh" display mode, or an adaptive
+-- tesselator for other display modes.
+-- @tparam Graphics graphics the @{Graphics} to add
+-- @treturn int 1-based index of the new member
+
+function Batch:add(graphics)
+	local member = {
+		graphics = graphics,
+		tess = graphics._display.tesselator or tove.newAdaptiveTesselator(),
+		mesh = ffi.gc(lib.NewColorMesh(graphics._name), lib.ReleaseMesh)}
+	tesselate(member, lib.UPDATE_MESH_EVERYTHING)
+	graphics:fetchChanges(lib.CHANGED_ANYTHING)
+	if lib.MeshBatchAdd(self._ref, member.mesh) < 0 then
+		return nil
+	end
+	table.insert(self._members, member)
+	return #self._members
+end
+
+--- Remove a member.
+-- Members after the removed one move down by one index.
+-- @tparam int i 1-based index of member
+
+function Batch:remove(i)
+	if lib.MeshBatchRemove(self._ref, i - 1) then
+		table.remove(self._members, i)
+	end
+end
+
+--- Get number of members.
+-- @treturn int number of members
+
+function Batch:getCount()
+	return #self._members
+end
+
+--- Set transform of a member.
+-- @tparam int i 1-based index of member
+-- @tparam number|Transform x x position, or a LÖVE <a href="https://love2d.org/wiki/Transform">Transform</a>
+-- @tparam[opt=0] number y y position
+-- @tparam[optchain=0] number r orientation in radians
+-- @tparam[optchain=1] number sx scale factor in x
+-- @tparam[optchain=sx] number sy scale factor in y
+
+function Batch:setTransform(i, x, y, r, sx, sy)
+	if type(x) ~= "number" then
+		local a, c, _, e, b, d, _, f = x:getMatrix()
+		lib.MeshBatchSetTransform(self._ref, i - 1, a, b, c, d, e, f)
+	else
+		r = r or 0
+		sx = sx or 1
+		sy = sy or sx
+		local cr, sr = math.cos(r), math.sin(r)
+		lib.MeshBatchSetTransform(self._ref, i - 1,
+			sx * cr, sx * sr, -sy * sr, sy * cr, x, y or 0)
+	end
+end
+
+local function updateMember(ref, i, member)
+	local flags = member.graphics:fetchChanges(lib.CHANGED_ANYTHING)
+	if flags == 0 then
+		if member.graphics._async then
+			lib.MeshBatchChanged(ref, i - 1,
+				lib.MeshSwapPendingTriangulations(member.mesh))
+		end
+		return
+	end
+	local tessFlags
+	if bit.band(flags, bit.bnot(_pointChanges)) == 0 then
+		tessFlags = lib.UPDATE_MESH_VERTICES + lib.UPDATE_MESH_AUTO_TRIANGLES
+	else
+		tessFlags = lib.UPDATE_MESH_EVERYTHING
+	end
+	lib.MeshBatchChanged(ref, i - 1, tesselate(member, tessFlags))
+end
+
+local function updateMesh(self)
+	local ref = self._ref
+	for i, member in ipairs(self._members) do
+		updateMember(ref, i, member)
+	end
+
+	local updates = lib.MeshBatchFetchUpdates(ref)
+
+	if bit.band(updates, lib.UPDATE_MESH_GEOMETRY) ~= 0 then
+		-- member vertex or index counts changed.
+		self._mesh = nil
+		local n = lib.MeshBatchGetVertexCount(ref)
+		local ni = lib.MeshBatchGetIndexCount(ref)
+		if n > 0 and ni > 0 then
+			self._mesh = love.graphics.newMesh(
+				_attributes, n, "triangles", self._usage)
+			self._vdata = love.data.newByteData(n * vertexByteSize)
+			self._idata = love.data.newByteData(ni * 4)
+		end
+	end
+
+	local mesh = self._mesh
+	if mesh == nil then
+		return nil
+	end
+
+	if bit.band(updates, lib.UPDATE_MESH_VERTICES) ~= 0 then
+		-- only upload the vertices of members that changed.
+		local data = self._vdata
+		local range = lib.MeshBatchCopyVertexData(
+			ref, data:getPointer(), data:getSize())
+		if range.count * vertexByteSize >= data:getSize() then
+			mesh:setVertices(data)
+		elseif range.count > 0 then
+			mesh:setVertices(love.data.newDataView(
+				data, range.first * vertexByteSize,
+				range.count * vertexByteSize), range.first + 1)
+		end
+	end
+
+	if bit.band(updates, lib.UPDATE_MESH_TRIANGLES) ~= 0 then
+		local idata = self._idata
+		lib.MeshBatchCopyIndexData(
+			ref, idata:getPointer(), idata:getSize() / 4)
+		mesh:setVertexMap(idata, "uint32")
+	end
+
+	return mesh
+end
+
+--- Draw all members.
+-- Member transforms get applied before the given transform.
+-- @tparam[opt=0] number x the x-axis position to draw at
+-- @tparam[opt=0] number y the y-axis position to draw at
+-- @tparam[opt=0] number r orientation in radians
+-- @tparam[opt=1] number sx scale factor in x
+-- @tparam[opt=1] number sy scale factor in y
+
+function Batch:draw(x, y, r, sx, sy)
+	local mesh = updateMesh(self)
+	if mesh ~= nil then
+		love.graphics.draw(mesh, x or 0, y or 0, r or 0, sx or 1, sy or 1)
+	end
+end
+
+return Batch
@@ -0,0 +1,134 @@
+-- *****************************************************************
+-- TÖVE - Animated vector graphics for LÖVE.
+-- https://github.com/poke1024/tove2d
+--
+-- Copyright (c) 2018, Bernhard Liebl
+--
+-- Distributed under the MIT license. See LICENSE file for details.
+--
+-- All rights reserved.
+-- *****************************************************************
+
+-- rigid meshes are not clipped geometrically. instead, each clip path
+-- gets a mesh of its own that is drawn into the stencil buffer, and
+-- paths are drawn in runs of paths that share the same clip paths.
+
+local lg = love.graphics
+
+local function newClipMeshes(graphics)
+	local gref = graphics._ref
+	local tsref = graphics._display.tesselator
+	local meshes = {}
+	for i = 1, lib.GraphicsGetNumClips(gref) do
+		local mesh = tove.newPositionMesh(graphics._name)
+		lib.TesselatorTessClip(tsref, gref, i - 1, mesh._tovemesh)
+		-- an empty clip path hides everything it clips.
+		meshes[i] = mesh:getMesh() or false
+	end
+	return meshes
+end
+
+local function getPathClips(graphics)
+	local gref = graphics._ref
+	local clips = {}
+	for i = 1, lib.GraphicsGetNumPaths(gref) do
+		local path = ffi.gc(lib.GraphicsGetPath(gref, i), lib.ReleasePath)
+		local indices = {}
+		for j = 1, lib.PathGetNumClipIndices(path) do
+			indices[j] = lib.PathGetClipIndex(path, j - 1) + 1
+		end
+		clips[i] = indices
+	end
+	return clips
+end
+
+local function sameClips(a, b)
+	if #a ~= #b then
+		return false
+	end
+	for i, c in ipairs(a) do
+		if b[i] ~= c then
+			return false
+		end
+	end
+	return true
+end
+
+-- groups consecutive paths with the same clip paths into index ranges.
+local function computeRuns(tovemesh, clips)
+	local runs = {}
+	local run = nil
+	for i, c in ipairs(clips) do
+		local range = lib.MeshGetPathIndexRange(tovemesh, i - 1)
+		if range.count > 0 then
+			if run ~= nil and sameClips(run.clips, c) and
+				run.first + run.count == range.first then
+				run.count = run.count + range.count
+			else
+				run = {clips = c, first = range.first, count = range.count}
+				table.insert(runs, run)
+			end
+		end
+	end
+	return runs
+end
+
+-- returns nil if the mesh needs no clipping when drawing. otherwise,
+-- returns a function(m, draw, ...) that calls draw(m, ...) for runs of
+-- paths in the love mesh m, with the stencil test set up for their
+-- clip paths. canvases drawn into need a stencil buffer.
+return function(graphics, mesh)
+	local gref = graphics._ref
+	if lib.GraphicsGetNumClips(gref) < 1 or
+		not lib.TesselatorHasFixedSize(graphics._display.tesselator) then
+		return nil
+	end
+
+	local clips = getPathClips(graphics)
+	local clipMeshes = nil
+	local runs, version = nil, nil
+
+	local stencilClips = nil
+	local x, y, r, sx, sy
+	local stencil = function()
+		for _, c in ipairs(stencilClips) do
+			local clipMesh = clipMeshes[c]
+			if clipMesh then
+				lg.draw(clipMesh, x, y, r, sx, sy)
+			end
+		end
+	end
+
+	return function(m, draw, ...)
+		if clipMeshes == nil or graphics._clipsChanged then
+			-- clip paths only change through Graphics:set.
+			clipMeshes = newClipMeshes(graphics)
+			graphics._clipsChanged = false
+		end
+		if runs == nil or mesh._indexVersion ~= version then
+			runs = computeRuns(mesh._tovemesh, clips)
+			version = mesh._indexVersion
+		end
+
+		x, y, r, sx, sy = ...
+		local shader = lg.getShader()
+		for _, run in ipairs(runs) do
+			local n = #run.clips
+			if n > 0 then
+				-- each clip mesh increments the stencil value once where
+				-- it covers, so we only draw where all clips cover.
+				stencilClips = run.clips
+				lg.setShader()
+				lg.stencil(stencil, "increment")
+				lg.setShader(shader)
+				lg.setStencilTest("equal", n)
+			end
+			m:setDrawRange(run.first + 1, run.count)
+			draw(m, ...)
+			if n > 0 then
+				lg.setStencilTest()
+			end
+		end
+		m:setDrawRange()
+	end
+end
@@ -9,18 +9,21 @@
 -- All rights reserved.
 -- *****************************************************************
 
+--!! import "clip.lua" as newStencilClip
+
 local function createDrawMesh(mesh, x0, y0, s)
 	if mesh == nil then
 		return function (x, y, r, sx, sy)
 		end
 	else
 		local draw = love.graphics.draw
+		-- the offset goes into the origin, so that it gets scaled
+		-- and rotated along with the mesh.
+		local ox, oy = -x0 / s, -y0 / s
 		return function (x, y, r, sx, sy)
 			sx = sx or 1
 			sy = sy or 1
-			x = (x or 0) + x0 * sx
-			y = (y or 0) + y0 * sy
-			draw(mesh, x, y, r or 0, s * sx, s * sy)
+			draw(mesh, x or 0, y or 0, r or 0, s * sx, s * sy, ox, oy)
 		end
 	end
 end
@@ -29,7 +32,9 @@ local function createDrawShaders(shaders)
 	local setShader = love.graphics.setShader
 	return function(...)
 		for _, s in ipairs(shaders) do
-			s:draw(...)
+			if s.visible then
+				s:draw(...)
+			end
 		end
 		setShader()
 	end
@@ -39,8 +44,25 @@ local function _updateBitmap(graphics)
 	return graphics:fetchChanges(lib.CHANGED_ANYTHING) ~= 0
 end
 
-local function _makeDrawFlatMesh(mesh)
-	return createDrawMesh(mesh:getMesh(), 0, 0, 1)
+local function _makeDrawFlatMesh(mesh, clip)
+	local m = mesh:getMesh()
+	local draw = createDrawMesh(m, mesh:getDrawTransform())
+	if m ~= nil and clip ~= nil then
+		local drawRange = function(_, ...)
+			draw(...)
+		end
+		return function (...)
+			clip(m, drawRange, ...)
+		end
+	end
+	if m == nil or not mesh:hasLODs() then
+		return draw
+	end
+	local abs, max = math.abs, math.max
+	return function (x, y, r, sx, sy)
+		mesh:selectLOD(max(abs(sx or 1), abs(sy or 1)))
+		draw(x, y, r, sx, sy)
+	end
 end
 
 local function _updateFlatMesh(graphics)
@@ -53,8 +75,8 @@ local function _updateFlatMesh(graphics)
 		return true -- recreate from scratch (might no longer be flat)
 	end
 
+	local mesh = graphics._cache.mesh
 	if bit.band(flags, lib.CHANGED_POINTS) ~= 0 then
-		local mesh = graphics._cache.mesh
 		if mesh:getUsage("points") == "static" then
 			tove.slow("static mesh points changed in " .. tove._str(graphics._name))
 		end
@@ -65,9 +87,16 @@ local function _updateFlatMesh(graphics)
 		if mesh:retesselate(tessFlags) then
 			-- retesselate indicated that the underlying mesh change. we need
 			-- to update the draw function that is bound to the love mesh.
-			graphics._cache.draw = _makeDrawFlatMesh(mesh)
+			graphics._cache.draw = _makeDrawFlatMesh(mesh, graphics._cache.clip)
 		end
+	elseif graphics._viewportChanged then
+		if mesh:retesselate(lib.UPDATE_MESH_VIEW) then
+			graphics._cache.draw = _makeDrawFlatMesh(mesh, graphics._cache.clip)
+		end
+	elseif graphics._async then
+		mesh:swapPendingTriangles()
 	end
+	graphics._viewportChanged = false
 
 	return false
 end
@@ -77,8 +106,9 @@ local function _updateShaders(graphics)
 		return true
 	end
 	-- update here to support Graphics:cache().
+	local view = graphics._viewport
 	for _, s in ipairs(graphics._cache.shaders) do
-		s:update()
+		s:update(view)
 	end
 	return false
 end
@@ -187,8 +217,15 @@ create.mesh = function(self)
 	local name = self._name
 
 	local gref = self._ref
+	local viewScale, minPathSize = unpack(self._view or {0, 0})
+	local occlusion = self._occlusion or false
+	local async = self._async or false
 	local tess = function(cmesh, flags)
-		return lib.TesselatorTessGraphics(tsref, gref, cmesh, flags)
+		lib.TesselatorSetViewScale(tsref, viewScale, minPathSize)
+		lib.TesselatorSetOcclusionCulling(tsref, occlusion)
+		lib.TesselatorSetAsyncTriangulation(tsref, async)
+		return lib.TesselatorTessGraphics(
+			tsref, gref, cmesh, flags, self._viewport)
 	end
 
 	if lib.GraphicsAreColorsSolid(self._ref) or
@@ -196,9 +233,17 @@ create.mesh = function(self)
 
 		local mesh = tove.newColorMesh(name, usage, tess)
 		local x0, y0, x1, y1 = self:computeAABB()
+		local clip = newStencilClip(self, mesh)
+		if clip == nil and self._viewport == nil and
+			usage["points"] == "static" and
+			(usage["triangles"] or "static") == "static" then
+			-- triangles never change, so reordering them once pays off.
+			lib.MeshSetOptimizeIndices(mesh._tovemesh, true)
+		end
 		return {
 			mesh = mesh,
-			draw = _makeDrawFlatMesh(mesh),
+			clip = clip,
+			draw = _makeDrawFlatMesh(mesh, clip),
 			warmup = function() end,
 			update = _updateFlatMesh,
 			updateQuality = function() return false end,
@@ -208,6 +253,7 @@ create.mesh = function(self)
 	else
 		local shader = _shaders.newMeshShader(
 			name, self, tess, usage, 1)
+		shader.clip = newStencilClip(self, shader.linkdata.mesh)
 
 		return {
 			mesh = shader:getMesh(),
@@ -275,5 +321,6 @@ return function(self)
 		error("invalid tove display mode: " .. (mode or "nil"))
 	end
 	self:fetchChanges(lib.CHANGED_ANYTHING) -- clear all changes
+	self._viewportChanged = false
 	return self._cache
 end
@@ -22,20 +22,63 @@ local AbstractMesh = {}
 AbstractMesh.__index = AbstractMesh
 
 function AbstractMesh:getNumTriangles()
-	return lib.MeshGetIndexCount(self._tovemesh) / 3
+	local lods = self._lods
+	if lods ~= nil then
+		return lods[self._lod].count / 3
+	end
+	local tovemesh = self._tovemesh
+	local n = lib.MeshGetIndexCount(tovemesh)
+	if lib.MeshGetIndexMode(tovemesh) == lib.TRIANGLES_STRIP then
+		return math.max(0, n - 2)
+	end
+	return n / 3
+end
+
+function AbstractMesh:getNumVertices()
+	local tovemesh = self._tovemesh
+	return lib.MeshGetVertexCount(tovemesh),
+		lib.MeshGetNumWeldedVertices(tovemesh)
 end
 
 function AbstractMesh:getUsage(what)
 	return self._usage[what]
 end
 
+local function updateCompactVertices(self)
+	local tovemesh = self._tovemesh
+	local vdata = self._vdata
+	local q = lib.MeshComputeQuantization(tovemesh)
+	self._quantization = q
+	lib.MeshCopyVertexData(tovemesh, lib.TOVE_VERTEX_UNORM16,
+		q, vdata:getPointer(), vdata:getSize())
+	self._mesh:setVertices(vdata)
+end
+
 function AbstractMesh:updateVertices()
 	local mesh = self._mesh
 	if mesh ~= nil then
+		if self._compact then
+			updateCompactVertices(self)
+			return
+		end
+
+		local tovemesh = self._tovemesh
 		local vdata = self._vdata
 		lib.MeshSetVertexBuffer(
-			self._tovemesh, vdata:getPointer(), vdata:getSize())
-		mesh:setVertices(vdata)
+			tovemesh, vdata:getPointer(), vdata:getSize())
+
+		-- only upload the vertices that actually got written.
+		local range = lib.MeshFetchDirtyRange(tovemesh)
+		if range.count > 0 then
+			if range.count * self._vertexByteSize >= vdata:getSize() then
+				mesh:setVertices(vdata)
+			else
+				local size = self._vertexByteSize
+				mesh:setVertices(love.data.newDataView(
+					vdata, range.first * size, range.count * size),
+					range.first + 1)
+			end
+		end
 	end
 end
 
@@ -44,6 +87,7 @@ function AbstractMesh:updateTriangles()
 	if mesh ~= nil then
 		local indexCount = lib.MeshGetIndexCount(self._tovemesh)
 		if indexCount < 1 then
+			self._mesh = nil -- e.g. all paths outside the viewport
 			return
 		end
 		local size = indexCount * indexSize
@@ -59,11 +103,76 @@ function AbstractMesh:updateTriangles()
 			self._tovemesh, idata:getPointer(), idata:getSize())
 
 		mesh:setVertexMap(idata, indexSize == 2 and "uint16" or "uint32")
+		-- optimized indices may switch between lists and strips.
+		local mode = getTrianglesMode(self._tovemesh)
+		if mesh:getDrawMode() ~= mode then
+			mesh:setDrawMode(mode)
+		end
+		self._indexVersion = (self._indexVersion or 0) + 1
+
+		local tovemesh = self._tovemesh
+		local numLODs = lib.MeshGetNumLODs(tovemesh)
+		if numLODs > 1 then
+			local lods = {}
+			for i = 1, numLODs do
+				lods[i] = lib.MeshGetLODIndexRange(tovemesh, i - 1)
+			end
+			self._lods = lods
+			self._lod = math.min(self._lod or 1, numLODs)
+			local range = lods[self._lod]
+			mesh:setDrawRange(range.first + 1, range.count)
+		else
+			self._lods = nil
+		end
 	else
 		self:getMesh()
 	end
 end
 
+function AbstractMesh:serializeTriangulations()
+	return ffi.string(lib.MeshSerializeTriangulations(self._tovemesh))
+end
+
+function AbstractMesh:deserializeTriangulations(s)
+	if not lib.MeshDeserializeTriangulations(self._tovemesh, s) then
+		return false
+	end
+	if self._mesh ~= nil then
+		self:updateTriangles()
+	end
+	return true
+end
+
+-- uses triangulations that finished on worker threads.
+function AbstractMesh:swapPendingTriangles()
+	local updated = lib.MeshSwapPendingTriangulations(self._tovemesh)
+	if updated ~= 0 and self._mesh ~= nil then
+		self:updateTriangles()
+	end
+end
+
+function AbstractMesh:hasLODs()
+	return self._lods ~= nil
+end
+
+-- selects the level of detail for drawing at the given scale. each
+-- level is meant for half the scale of the previous one.
+function AbstractMesh:selectLOD(scale)
+	local lods = self._lods
+	if lods ~= nil then
+		local level = 1
+		if scale > 0 then
+			level = math.max(1, math.min(#lods,
+				1 + math.floor(-math.log(scale) / math.log(2))))
+		end
+		if level ~= self._lod then
+			local range = lods[level]
+			self._mesh:setDrawRange(range.first + 1, range.count)
+			self._lod = level
+		end
+	end
+end
+
 function AbstractMesh:cacheKeyFrame()
 	lib.MeshCacheKeyFrame(self._tovemesh)
 end
@@ -87,8 +196,23 @@ function AbstractMesh:getMesh()
 		return nil
 	end
 
+	local usage = self:getMeshUsage()
+
+	if self._compact then
+		-- positions as unorm16 relative to the mesh bounds, see
+		-- AbstractMesh:getDrawTransform.
+		local mesh = love.graphics.newMesh(
+			self._compactAttributes, n, getTrianglesMode(self._tovemesh), usage)
+		self._mesh = mesh
+		self._vdata = love.data.newByteData(n * lib.MeshGetVertexByteSize(
+			self._tovemesh, lib.TOVE_VERTEX_UNORM16))
+		self:updateVertices()
+		self:updateTriangles()
+		return mesh
+	end
+
 	local mesh = love.graphics.newMesh(
-		self._attributes, n, getTrianglesMode(self._tovemesh), self:getMeshUsage())
+		self._attributes, n, getTrianglesMode(self._tovemesh), usage)
 	self._mesh = mesh
 	self._vdata = love.data.newByteData(n * self._vertexByteSize)
 
@@ -98,6 +222,16 @@ function AbstractMesh:getMesh()
 	return mesh
 end
 
+-- returns x0, y0, scale to draw this mesh with in original coordinates.
+function AbstractMesh:getDrawTransform()
+	local q = self._quantization
+	if self._compact and q ~= nil then
+		return q.x0, q.y0, 1 / q.scale
+	else
+		return 0, 0, 1
+	end
+end
+
 
 local PositionMesh = {}
 PositionMesh.__index = PositionMesh
@@ -148,6 +282,9 @@ ColorMesh._attributes = {
 	{"VertexPosition", "float", 2},
 	{"VertexColor", "byte", 4}}
 ColorMesh._vertexByteSize = 2 * floatSize + 4
+ColorMesh._compactAttributes = {
+	{"VertexPosition", "unorm16", 2},
+	{"VertexColor", "byte", 4}}
 
 function ColorMesh:getMeshUsage()
 	local u = self._usage
@@ -168,6 +305,8 @@ tove.newColorMesh = function(name, usage, tess)
 	return setmetatable({
 		_name = name, _tovemesh = cmesh, _mesh = nil,
 		_tess = tess, _usage = usage,
+		_compact = usage.vertices == "compact" and
+			(usage.points or "static") == "static",
 		_vdata = nil}, ColorMesh)
 end
 
@@ -184,9 +323,16 @@ function ColorMesh:retesselate(flags)
 		lib.UPDATE_MESH_VERTICES +
 		lib.UPDATE_MESH_COLORS) ~= 0 then
 		self:updateVertices()
+		if self._compact then
+			return true  -- quantization, i.e. draw transform changed
+		end
 	end
 	if bit.band(updated, lib.UPDATE_MESH_TRIANGLES) ~= 0 then
+		local mesh = self._mesh
 		self:updateTriangles()
+		if self._mesh ~= mesh then
+			return true  -- the mesh was dropped or created
+		end
 	end
 
 	return false
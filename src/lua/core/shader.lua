@@ -166,13 +166,35 @@ function MeshShader:update()
 		if self.usage["triangles"] ~= "static" then
 			tessFlags = bit.bor(tessFlags, lib.UPDATE_MESH_AUTO_TRIANGLES)
 		end
-		local updated = self.tess(linkdata.mesh._tovemesh, tessFlags)
+		local mesh = linkdata.mesh
+		local updated = self.tess(mesh._tovemesh, tessFlags)
 
-		linkdata.mesh:updateVertices()
-		if bit.band(updated, lib.UPDATE_MESH_TRIANGLES) ~= 0 then
-			linkdata.mesh:updateTriangles()
+		if bit.band(updated, lib.UPDATE_MESH_GEOMETRY) ~= 0 then
+			-- e.g. dashes moved, recreated in getMesh().
+			mesh._mesh = nil
+		else
+			mesh:updateVertices()
+			if bit.band(updated, lib.UPDATE_MESH_TRIANGLES) ~= 0 then
+				mesh:updateTriangles()
+			end
+		end
+	elseif graphics._viewportChanged then
+		local mesh = linkdata.mesh
+		local updated = self.tess(mesh._tovemesh, lib.UPDATE_MESH_VIEW)
+		if bit.band(updated, lib.UPDATE_MESH_GEOMETRY) ~= 0 then
+			mesh._mesh = nil -- new vertices, recreated in getMesh()
+		else
+			if bit.band(updated, lib.UPDATE_MESH_VERTICES) ~= 0 then
+				mesh:updateVertices()
+			end
+			if bit.band(updated, lib.UPDATE_MESH_TRIANGLES) ~= 0 then
+				mesh:updateTriangles()
+			end
 		end
+	elseif graphics._async then
+		linkdata.mesh:swapPendingTriangles()
 	end
+	graphics._viewportChanged = false
 
 	local link = linkdata.link
 	local chg1 = lib.FeedBeginUpdate(link)
@@ -195,7 +217,12 @@ function MeshShader:draw(...)
 	local mesh = linkdata.mesh:getMesh()
 	if mesh ~= nil then
 		lg.setShader(linkdata.shader)
-		lg.draw(mesh, ...)
+		local clip = self.clip
+		if clip ~= nil then
+			clip(mesh, lg.draw, ...)
+		else
+			lg.draw(mesh, ...)
+		end
 		lg.setShader(nil)
 	end
 end
@@ -305,12 +332,21 @@ end
 local newComputeShader = function(path, quality)
 	return setmetatable({
 		path = path,
+		visible = true,
 		linkdata = newComputeFeedData(path, quality)
 	}, ComputeShader)
 end
 
-function ComputeShader:update()
+function ComputeShader:update(view)
 	local path = self.path
+
+	-- paths outside the view keep their changes pending in the
+	-- feed until they come into view again.
+	self.visible = view == nil or lib.PathIntersects(path, view)
+	if not self.visible then
+		return
+	end
+
 	local linkdata = self.linkdata
 	local link = linkdata.link
 
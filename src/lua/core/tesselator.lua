@@ -9,7 +9,11 @@
 -- All rights reserved.
 -- *****************************************************************
 
-tove.newAdaptiveTesselator = function(resolution, recursionLimit)
+tove.newAdaptiveTesselator = function(resolution, recursionLimit, levels)
+	if (levels or 1) > 1 then
+		return ffi.gc(lib.NewAdaptiveLODTesselator(
+			resolution or 128, recursionLimit or 8, levels), lib.ReleaseTesselator)
+	end
 	return ffi.gc(lib.NewAdaptiveTesselator(
 		resolution or 128, recursionLimit or 8), lib.ReleaseTesselator)
 end
@@ -69,9 +69,15 @@
 -- and need less points. The number of vertices produced by
 -- Adaptive Tesselators depends on the specific geometry. They are not suited for shape animation, as each shape
 -- change would result in a different number of vertices and triangles.
+-- Adaptive Tesselators can also build a chain of coarser meshes (levels of detail) from
+-- one flattening pass; when drawing, a level is chosen from the draw scale, each level being
+-- meant for half the scale of the previous one.
+-- @usage
+-- graphics:setDisplay("mesh", "adaptive", 1024, 8, 4) -- 4 levels of detail
 -- @function tove.newAdaptiveTesselator
 -- @tparam number resolution resolution at which the mesh should look good
 -- @tparam[opt] int recursionLimit maximum number of recursions during subdivision
+-- @tparam[optchain=1] int levels number of levels of detail
 
 --- Create a rigid tesselator.
 -- Use this to obtain low or medium quality meshes that can distort and animate their shapes in realtime.
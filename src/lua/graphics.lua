@@ -143,6 +143,10 @@ function Graphics:clone()
 		_cache = nil,
 		_display = makeDisplay(d.mode, d.quality, self._usage),
 		_resolution = self._resolution,
+		_view = self._view,
+		_occlusion = self._occlusion,
+		_async = self._async,
+		_viewport = self._viewport,
 		_usage = newUsage(),
 		_name = ffi.gc(lib.CloneName(self._name), lib.ReleaseName),
 		paths = setmetatable({_ref = ref}, Paths)}, Graphics)
@@ -530,10 +534,98 @@ function Graphics:setResolution(resolution)
 	end
 end
 
+--- Set view scale.
+-- Tells adaptive tesselators at which scale this @{Graphics} will be drawn, so that
+-- curve subdivision can be chosen per path from its size on screen, instead of from
+-- the tesselator's resolution. Paths smaller than a given number of pixels can be
+-- dropped altogether, which helps with dense icon sheets.
+-- @usage
+-- g:setDisplay("mesh", "adaptive")
+-- g:setViewScale(0.25, 1) -- drawn at 1/4 size, skip paths below 1 pixel
+-- @tparam number|nil scale pixels per unit when drawn, or nil to use the tesselator's resolution
+-- @tparam[opt=0] number minSize size in pixels below which paths are not drawn
+-- @see Graphics:setDisplay
+
+function Graphics:setViewScale(scale, minSize)
+	if scale ~= nil then
+		self._view = {scale, minSize or 0}
+	else
+		self._view = nil
+	end
+	self._cache = nil
+end
+
+--- Set occlusion culling.
+-- Tells adaptive tesselators to cut away fill geometry that is hidden under opaque
+-- fills drawn above it, and to drop hidden fills altogether. This reduces overdraw
+-- for layered artwork. Only applies to flat meshes, i.e. meshes without shaders,
+-- as paint changes in other meshes do not tesselate again.
+-- @usage
+-- g:setDisplay("mesh", "adaptive")
+-- g:setOcclusionCulling(true)
+-- @tparam boolean enabled whether to cull hidden fills
+-- @see Graphics:setDisplay
+
+function Graphics:setOcclusionCulling(enabled)
+	if enabled ~= (self._occlusion or false) then
+		self._occlusion = enabled
+		self._cache = nil
+	end
+end
+
+--- Set asynchronous triangulation.
+-- When animated rigid meshes change their shape so much that none of their cached
+-- triangulations fits anymore, triangulating again can take several milliseconds.
+-- With asynchronous triangulation, this happens on a worker thread, while drawing
+-- continues with the previous triangles. The new triangles are used as soon as
+-- they are ready. Meshes might show artifacts for a few frames.
+-- @usage
+-- g:setDisplay("mesh", "rigid", 4)
+-- g:setAsyncTriangulation(true)
+-- @tparam boolean enabled whether to triangulate in the background
+-- @see Graphics:setDisplay
+
+function Graphics:setAsyncTriangulation(enabled)
+	if enabled ~= (self._async or false) then
+		self._async = enabled
+		self._cache = nil
+	end
+end
+
+--- Set viewport.
+-- Restricts drawing to the @{Path}s that overlap the given rectangle, which is given
+-- in the coordinate system of this @{Graphics} (e.g. the visible part of a large map).
+-- In "mesh" mode, paths outside the viewport are not tesselated until they come into
+-- view; in "gpux" mode, their shaders are neither updated nor drawn. Moving the
+-- viewport does not recreate the mesh.
+-- @usage
+-- g:setViewport(camera.x, camera.y, camera.x + w, camera.y + h)
+-- @tparam number|nil x0 left border, or nil to draw all paths
+-- @tparam number y0 top border
+-- @tparam number x1 right border
+-- @tparam number y1 bottom border
+-- @see Graphics:setViewScale
+
+function Graphics:setViewport(x0, y0, x1, y1)
+	if x0 ~= nil then
+		local view = ffi.new("ToveBounds")
+		view.x0 = x0
+		view.y0 = y0
+		view.x1 = x1
+		view.y1 = y1
+		self._viewport = view
+	else
+		self._viewport = nil
+	end
+	self._viewportChanged = true
+end
+
 --- Set usage.
 -- Indicates which elements of the @{Graphics} you want to change (i.e. animate) at runtime.
 -- Currently, this method only has an effect for display mode "mesh".
 -- Hint: to force meshes to not use shaders, use g:setUsage("shaders", "avoid").
+-- Hint: for static flat meshes, g:setUsage("vertices", "compact") stores positions as
+-- 16 bit fixed point relative to the mesh bounds, which halves vertex memory.
 -- @usage
 -- g:setUsage("points", "stream") -- animate points on each frame
 -- g:setUsage("colors", "stream") -- animate colors on each frame
@@ -598,6 +690,87 @@ function Graphics:setCacheSize(size)
 	self._cache.setCacheSize(self._cache, size)
 end
 
+--- Save cached triangulations.
+-- In "mesh" display mode, returns all triangulations cached so far (e.g. through
+-- @{Graphics:cacheKeyFrame}) as a string. Ship this string with your game and
+-- pass it to @{Graphics:loadTriangulations} to skip computing the triangulations
+-- at startup.
+-- @usage
+-- love.filesystem.write("walk.tri", g:saveTriangulations())
+-- @treturn string|nil triangulations, or nil if not in "mesh" display mode
+-- @see loadTriangulations
+
+function Graphics:saveTriangulations()
+	self:_create()
+	if self._display.mode ~= "mesh" then
+		return nil
+	end
+	return self._cache.mesh:serializeTriangulations()
+end
+
+--- Load cached triangulations.
+-- Replaces the cached triangulations with ones from @{Graphics:saveTriangulations}.
+-- Fails if this @{Graphics} has a different structure or display than the one
+-- saved from. Changing the display later on discards the loaded triangulations.
+-- @usage
+-- g:loadTriangulations(love.filesystem.read("walk.tri"))
+-- @tparam string s triangulations as returned from @{Graphics:saveTriangulations}
+-- @treturn bool true if the triangulations could be loaded
+-- @see saveTriangulations
+
+function Graphics:loadTriangulations(s)
+	self:_create()
+	if self._display.mode ~= "mesh" then
+		return false
+	end
+	return self._cache.mesh:deserializeTriangulations(s)
+end
+
+--- Set internal key frame cache budget.
+-- Limits the memory in bytes that cached triangulations of this @{Graphics}
+-- use in "mesh" mode. Once exceeded, the least recently used triangulations get
+-- evicted, though never key frames. See `tove.setCacheBudget` for a limit shared
+-- by all @{Graphics}.
+-- @tparam int bytes maximum number of bytes, or 0 for no limit
+-- @see setCacheSize
+-- @see getCacheStats
+
+function Graphics:setCacheBudget(bytes)
+	self:_create()
+	if self._display.mode == "mesh" then
+		lib.MeshSetTriangleCacheBudget(self._cache.mesh._tovemesh, bytes or 0)
+	end
+end
+
+--- Get internal key frame cache statistics.
+-- @treturn table|nil `bytes`, `budget`, `triangulations`, `evicted` and
+-- `evictedOverBudget`, or nil if not in "mesh" display mode
+-- @see setCacheBudget
+
+function Graphics:getCacheStats()
+	self:_create()
+	if self._display.mode ~= "mesh" then
+		return nil
+	end
+	return tove._cacheStats(lib.MeshGetTriangleCacheStats(
+		self._cache.mesh._tovemesh))
+end
+
+--- Get memory used internally.
+-- Counts memory that TÖVE holds for this @{Graphics}' mesh, i.e. not
+-- LÖVE objects like Meshes or Textures. See `tove.getMemoryUsage` for all memory.
+-- @treturn table|nil bytes by `meshes`, `triangles`, `cleaners` and `total`, or
+-- nil if not in "mesh" display mode
+
+function Graphics:getMemoryUsage()
+	self:_create()
+	if self._display.mode ~= "mesh" then
+		return nil
+	end
+	return tove._memoryStats(lib.MeshGetMemoryUsage(
+		self._cache.mesh._tovemesh))
+end
+
 function Graphics:set(arg, swl)
 	if getmetatable(arg) == tove.Transform then
 		lib.GraphicsSet(
@@ -611,12 +784,15 @@ function Graphics:set(arg, swl)
 			arg._ref,
 			false, 1, 0, 0, 0, 1, 0)
 	end
+	self._clipsChanged = true
 end
 
 --  @set no_summary=true
 --- Transform this @{Graphics}.
 -- Use this to transform all points in a @{Graphics} with an affine matrix. Don't use this for
 -- drawing a rotated or scaled version of your @{Graphics}, use @{Graphics:draw} instead. 
+-- Rotations, uniform scales and translations move existing mesh vertices instead of
+-- tesselating again.
 -- Also see <a href="https://love2d.org/wiki/love.math.newTransform">love.math.newTransform</a>.
 -- @usage
 -- g:transform(0, 0, 0, sx, sy)  -- scale by (sx, sy)
@@ -669,6 +845,21 @@ function Graphics:getNumTriangles()
 	end
 end
 
+--- Get number of vertices.
+-- Adaptive meshes weld identical points into one vertex; the second return
+-- value tells how many vertices this saved.
+-- @treturn int number of vertices in the mesh drawing this @{Graphics}
+-- @treturn int number of vertices saved through welding
+
+function Graphics:getNumVertices()
+	self:_create()
+	if self._cache ~= nil and self._cache.mesh ~= nil then
+		return self._cache.mesh:getNumVertices()
+	else
+		return 4, 0
+	end
+end
+
 --- Draw to screen.
 -- The details of how the rendering happens can get configured through
 -- @{Graphics:setDisplay}.
@@ -762,6 +953,18 @@ function Graphics:animate(a, b, t)
 	lib.GraphicsAnimate(self._ref, a._ref, b._ref, t or 0)
 end
 
+--- Pack points for animation.
+-- Keeps all points of this @{Graphics} in one contiguous buffer, so that
+-- @{Graphics:animate} can interpolate all of them in one go. Only pays
+-- off if you animate between @{Graphics} with identical structure (e.g.
+-- after a morph) on each frame.
+-- @tparam[opt=true] bool packed enable or disable packing
+-- @see Graphics:animate
+
+function Graphics:setPackedPoints(packed)
+	lib.GraphicsSetPackedPoints(self._ref, packed ~= false)
+end
+
 --- Warp points.
 -- Allows you to change the shape of a vector graphics in a way
 -- that animates well.
@@ -777,8 +980,15 @@ end
 
 function Graphics:warp(f)
 	local paths = self.paths
-    for i = 1, paths.count do
-		paths[i]:warp(f)
+	lib.BeginChangeBatch()
+	local ok, err = pcall(function()
+		for i = 1, paths.count do
+			paths[i]:warp(f)
+		end
+	end)
+	lib.EndChangeBatch()
+	if not ok then
+		error(err)
 	end
 end
 
@@ -804,6 +1014,29 @@ function Graphics:clean(eps)
 	lib.GraphicsClean(self._ref, eps or 1e-2)
 end
 
+--- Optimize static artwork.
+-- Merges touching paths that have the same opaque solid fill and no line,
+-- and that are drawn right after each other, into one @{Path}. Removes
+-- paths that are completely hidden under opaque fills drawn above them.
+-- Merged paths consist of flattened line segments, so use this only on
+-- artwork you do not animate, e.g. imported SVGs with many small paths.
+-- @tparam[opt=128] number resolution resolution for flattening curves, as in
+-- tove.newAdaptiveTesselator
+-- @treturn table statistics with fields paths and vertices (each holding
+-- before and after), occluded (number of removed paths) and merged (number
+-- of paths merged into others)
+
+function Graphics:optimize(resolution)
+	local tess = tove.newAdaptiveTesselator(resolution)
+	local stats = lib.GraphicsOptimize(self._ref, tess)
+	return {
+		paths = {before = stats.numPathsBefore, after = stats.numPathsAfter},
+		vertices = {before = stats.numVerticesBefore, after = stats.numVerticesAfter},
+		occluded = stats.numOccluded,
+		merged = stats.numMerged
+	}
+end
+
 --- Check if inside.
 -- Returns true if the given point is inside any of the @{Graphics}'s @{Path}s.
 -- @tparam number x x coordinate of tested point
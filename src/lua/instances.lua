@@ -0,0 +1,188 @@
+-- *****************************************************************
+-- TÖVE - Animated vector graphics for LÖVE.
+-- https://github.com/poke1024/tove2d
+--
+-- Copyright (c) 2018, Bernhard Liebl
+--
+-- Distributed under the MIT license. See LICENSE file for details.
+--
+-- All rights reserved.
+-- *****************************************************************
+
+--- Many transformed copies of one @{Graphics}.
+-- @classmod InstanceSet
+-- @set sort=true
+
+-- matches the layout of ToveInstance.
+local _attributes = {
+	{"InstanceMatrix", "float", 4},
+	{"InstanceTranslation", "float", 2},
+	{"InstanceTint", "byte", 4}}
+
+local instanceByteSize = ffi.sizeof("ToveInstance")
+
+local _shader = nil
+
+local function getShader()
+	if _shader == nil then
+		_shader = love.graphics.newShader(ffi.string(lib.GetInstanceShaderCode()))
+	end
+	return _shader
+end
+
+local InstanceSet = {}
+InstanceSet.__index = InstanceSet
+
+--- Create new instance set.
+-- All instances share the mesh of the given @{Graphics}, which is tesselated
+-- only once. Changing transforms, tints and opacities of instances only
+-- updates a small per-instance buffer. Needs the `"mesh"` display mode; non-solid
+-- paints get rendered as with @{Graphics:setUsage}`("shaders", "avoid")`.
+-- @usage
+-- stars = tove.newInstanceSet(star, 1000)
+-- for i = 1, 1000 do
+--     stars:setTransform(i, math.random() * 800, math.random() * 600)
+-- end
+-- stars:draw()
+-- @tparam Graphics graphics the @{Graphics} to draw
+-- @tparam[opt=0] int n number of instances
+
+tove.newInstanceSet = function(graphics, n)
+	local set = setmetatable({
+		_ref = ffi.gc(lib.NewInstanceSet(), lib.ReleaseInstanceSet),
+		_graphics = graphics,
+		_mesh = nil,
+		_data = nil,
+		_attached = nil}, InstanceSet)
+	set:setCount(n or 0)
+	return set
+end
+
+--- Set number of instances.
+-- New instances are untransformed, untinted and opaque.
+-- @tparam int n number of instances
+
+function InstanceSet:setCount(n)
+	lib.InstanceSetResize(self._ref, n)
+	self._mesh = nil
+	self._data = nil
+	self._attached = nil
+end
+
+--- Get number of instances.
+-- @treturn int number of instances
+
+function InstanceSet:getCount()
+	return lib.InstanceSetGetSize(self._ref)
+end
+
+--- Set transform of an instance.
+-- @tparam int i 1-based index of instance
+-- @tparam number|Transform x x position, or a LÖVE <a href="https://love2d.org/wiki/Transform">Transform</a>
+-- @tparam[opt=0] number y y position
+-- @tparam[optchain=0] number r orientation in radians
+-- @tparam[optchain=1] number sx scale factor in x
+-- @tparam[optchain=sx] number sy scale factor in y
+
+function InstanceSet:setTransform(i, x, y, r, sx, sy)
+	if type(x) ~= "number" then
+		local a, c, _, e, b, d, _, f = x:getMatrix()
+		lib.InstanceSetSetTransform(self._ref, i - 1, a, b, c, d, e, f)
+	else
+		r = r or 0
+		sx = sx or 1
+		sy = sy or sx
+		local cr, sr = math.cos(r), math.sin(r)
+		lib.InstanceSetSetTransform(self._ref, i - 1,
+			sx * cr, sx * sr, -sy * sr, sy * cr, x, y or 0)
+	end
+end
+
+--- Set tint of an instance.
+-- The tint gets multiplied with the colors of the @{Graphics}.
+-- @tparam int i 1-based index of instance
+-- @tparam number r red
+-- @tparam number g green
+-- @tparam number b blue
+-- @tparam[opt=1] number a alpha
+
+function InstanceSet:setTint(i, r, g, b, a)
+	lib.InstanceSetSetTint(self._ref, i - 1, r, g, b, a or 1)
+end
+
+--- Set opacity of an instance.
+-- @tparam int i 1-based index of instance
+-- @tparam number opacity opacity between 0 and 1
+
+function InstanceSet:setOpacity(i, opacity)
+	lib.InstanceSetSetOpacity(self._ref, i - 1, opacity)
+end
+
+local function updateInstances(self, n)
+	local imesh = self._mesh
+	if imesh == nil then
+		imesh = love.graphics.newMesh(_attributes, n, "points", "dynamic")
+		self._mesh = imesh
+		self._data = love.data.newByteData(n * instanceByteSize)
+	end
+
+	-- only upload the instances that actually changed.
+	local data = self._data
+	local range = lib.InstanceSetCopyData(
+		self._ref, data:getPointer(), data:getSize())
+	if range.count >= n then
+		imesh:setVertices(data)
+	elseif range.count > 0 then
+		imesh:setVertices(love.data.newDataView(
+			data, range.first * instanceByteSize,
+			range.count * instanceByteSize), range.first + 1)
+	end
+
+	return imesh
+end
+
+--- Draw all instances.
+-- Instance transforms get applied before the given transform.
+-- @tparam[opt=0] number x the x-axis position to draw at
+-- @tparam[opt=0] number y the y-axis position to draw at
+-- @tparam[opt=0] number r orientation in radians
+-- @tparam[opt=1] number sx scale factor in x
+-- @tparam[opt=1] number sy scale factor in y
+
+function InstanceSet:draw(x, y, r, sx, sy)
+	local n = lib.InstanceSetGetSize(self._ref)
+	if n < 1 then
+		return
+	end
+
+	local graphics = self._graphics
+	if graphics._display.mode ~= "mesh" then
+		tove.warn("instancing needs display mode \"mesh\" in " ..
+			tove._str(graphics._name))
+		return
+	end
+	if not lib.GraphicsAreColorsSolid(graphics._ref) and
+		graphics._usage["shaders"] ~= "avoid" then
+		graphics:setUsage("shaders", "avoid")
+	end
+
+	local cache = graphics:_create()
+	local mesh = cache.mesh:getMesh()
+	if mesh == nil then
+		return
+	end
+
+	local imesh = updateInstances(self, n)
+	if self._attached ~= mesh then
+		for _, attribute in ipairs(_attributes) do
+			mesh:attachAttribute(attribute[1], imesh, "perinstance")
+		end
+		self._attached = mesh
+	end
+
+	local shader = getShader()
+	shader:send("mesh_transform", {cache.mesh:getDrawTransform()})
+	love.graphics.setShader(shader)
+	love.graphics.drawInstanced(mesh, n, x or 0, y or 0, r or 0, sx or 1, sy or 1)
+	love.graphics.setShader()
+end
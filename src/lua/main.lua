@@ -131,6 +131,48 @@ tove.init = function(path)
 		end
 	end
 
+	tove._cacheStats = function(s)
+		return {
+			bytes = tonumber(s.bytes),
+			budget = tonumber(s.budget),
+			triangulations = s.numTriangulations,
+			evicted = s.numEvicted,
+			evictedOverBudget = s.numEvictedOverBudget}
+	end
+
+	-- limits the memory all triangulation caches use together. when a
+	-- cache exceeds it, it evicts its least recently used entries.
+	tove.setCacheBudget = function(bytes)
+		lib.SetTriangleCacheBudget(bytes or 0)
+	end
+
+	tove.getCacheStats = function()
+		return tove._cacheStats(lib.GetTriangleCacheStats())
+	end
+
+	tove._memoryStats = function(s)
+		return {
+			meshes = tonumber(s.meshes),
+			triangles = tonumber(s.triangles),
+			cleaners = tonumber(s.cleaners),
+			geometry = tonumber(s.geometry),
+			gradients = tonumber(s.gradients),
+			parser = tonumber(s.parser),
+			total = tonumber(s.total),
+			budget = tonumber(s.budget)}
+	end
+
+	-- limits the memory TÖVE holds in total (not counting LÖVE objects).
+	-- once exceeded, triangulation caches evict their least recently
+	-- used entries.
+	tove.setMemoryBudget = function(bytes)
+		lib.SetMemoryBudget(bytes or 0)
+	end
+
+	tove.getMemoryUsage = function()
+		return tove._memoryStats(lib.GetMemoryUsage())
+	end
+
 	local env = {
 		graphics = love.graphics.getSupported(),
 		rgba16f = love.graphics.getCanvasFormats()["rgba16f"],
@@ -308,6 +350,8 @@ tove.init = function(path)
 	--!! import "shape.lua" as Shape
 
 	--!! import "animation.lua" as Animation
+	--!! import "instances.lua" as InstanceSet
+	--!! import "batch.lua" as Batch
 end
 
 tove.init()